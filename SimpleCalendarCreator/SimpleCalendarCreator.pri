@@ -39,7 +39,28 @@ HEADERS += ./src/element/Dates.hpp \
     ./src/window/CalendarResizer.hpp \
     ./src/window/ObjectCreator.hpp \
     ./resource.h \
-    ./src/window/About.hpp
+    ./src/window/About.hpp \
+    ./src/render/MonthRenderer.hpp \
+    ./src/render/CalendarExporter.hpp \
+    ./src/render/BoundedQueue.hpp \
+    ./src/project/ProjectFile.hpp \
+    ./src/render/BatchRenderer.hpp \
+    ./src/render/TextLayoutCache.hpp \
+    ./src/element/PropertiesHash.hpp \
+    ./src/render/PreviewCache.hpp \
+    ./src/window/TiledMonthItem.hpp \
+    ./src/element/OutlineGraphic.hpp \
+    ./src/render/ScanlineSink.hpp \
+    ./src/render/PngStreamWriter.hpp \
+    ./src/render/VectorExporter.hpp \
+    ./src/render/ExportPreset.hpp \
+    ./src/project/ZipBufferWriter.hpp \
+    ./src/project/DesignWriter.hpp \
+    ./src/project/DesignReader.hpp \
+    ./src/project/ProjectConverter.hpp \
+    ./src/project/ProjectLoader.hpp \
+    ./src/project/ProjectSaver.hpp \
+    ./src/project/EditJournal.hpp
 SOURCES += ./src/element/Dates.cpp \
     ./src/element/WeakTitle.cpp \
     ./src/window/EditProjectInfo.cpp \
@@ -69,7 +90,24 @@ SOURCES += ./src/element/Dates.cpp \
     ./src/window/object_editor/EditWeakTitle.cpp \
     ./src/window/PreviewWindow.cpp \
     ./src/window/SimpleCalendarCreator.cpp \
-    ./src/window/About.cpp
+    ./src/window/About.cpp \
+    ./src/render/MonthRenderer.cpp \
+    ./src/render/CalendarExporter.cpp \
+    ./src/project/ProjectFile.cpp \
+    ./src/render/BatchRenderer.cpp \
+    ./src/render/TextLayoutCache.cpp \
+    ./src/render/PreviewCache.cpp \
+    ./src/window/TiledMonthItem.cpp \
+    ./src/element/OutlineGraphic.cpp \
+    ./src/render/PngStreamWriter.cpp \
+    ./src/render/VectorExporter.cpp \
+    ./src/project/ZipBufferWriter.cpp \
+    ./src/project/DesignWriter.cpp \
+    ./src/project/DesignReader.cpp \
+    ./src/project/ProjectConverter.cpp \
+    ./src/project/ProjectLoader.cpp \
+    ./src/project/ProjectSaver.cpp \
+    ./src/project/EditJournal.cpp
 FORMS += ./src/window/EditProjectInfo.ui \
     ./src/window/object_editor/EditDates.ui \
     ./src/window/object_editor/EditEllipse.ui \
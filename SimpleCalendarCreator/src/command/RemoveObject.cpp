@@ -46,6 +46,10 @@ namespace command
         if (pixmapItem != nullptr)
             scene->addItem(pixmapItem);
 
-        list->insertItem(index.row(), item.release());
+        auto restored = item.release();
+        list->insertItem(index.row(), restored);
+        //Outline of an object removed before it is rendered is still dirty.
+        if (pixmapItem == nullptr)
+            restored->renderOutline();
     }
 }
@@ -20,16 +20,20 @@ void UndoHistory::push(std::unique_ptr<command::Command> command) noexcept
         return;
     }
     unsave = true;
+    revision++;
+    historyChanged();
 }
 
 void UndoHistory::pop() noexcept
 {
     tracer.top()->unexecute();
     tracer.pop();
+    revision++;
 
     //Identify if the last operation is the first operation. Mark as no changes if true.
     if (tracer.empty()) unsave = false;
     else unsave = true;
+    historyChanged();
 }
 
 bool UndoHistory::hasUnsave() noexcept
@@ -42,7 +46,19 @@ void UndoHistory::changesSaved() noexcept
     unsave = false;
 }
 
+void UndoHistory::changesMade() noexcept
+{
+    unsave = true;
+    revision++;
+}
+
 void UndoHistory::clearHistory() noexcept
 {
     tracer.swap(decltype(tracer){});
+    revision++;
+}
+
+std::uint64_t UndoHistory::getRevision() const noexcept
+{
+    return revision;
 }
@@ -4,9 +4,12 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <stack>
 
+#include <boost/signals2.hpp>
+
 #include "command/Command.hpp"
 /**
  * @brief Singletone object that hold the history of all user's operation and provide undo functionality.
@@ -41,10 +44,31 @@ public:
      * Update the unsave status to saved.
      */
     void changesSaved() noexcept;
+    /**
+     * Mark the document as changed by an operation that is not traced by the undo stack, such as changes
+     * recovered from the edit journal.
+     */
+    void changesMade() noexcept;
     /**
      * Clear all undo history.
      */
     void clearHistory() noexcept;
+    /**
+     * Get the revision of the document, increased whenever a command is executed or undone and when the
+     * history is cleared. Used to detect if the document changed since the last time it was read.
+     */
+    std::uint64_t getRevision() const noexcept;
+
+public:  //Signals
+    /**
+     * @name Signals
+     * @{
+     */
+    /**
+     * Fired after a command is executed by push() or undone by pop().
+     */
+    boost::signals2::signal<void()> historyChanged;
+    /** @} */
 protected:
     ~UndoHistory() noexcept = default;
 private:
@@ -56,6 +80,11 @@ private:  //Attributes
      * Determine if user have unchange.
      */
     bool unsave{ false };
+    /**
+     * @internal
+     * Revision of the document.
+     */
+    std::uint64_t revision{ 0 };
     /**
      * @internal
      * Stack to trace user's operations.
@@ -13,6 +13,8 @@
 #include <qdebug.h>
 #endif // _DEBUG
 
+std::uint64_t CustomListWidgetItem::lastChangeStamp{ 0 };
+
 CustomListWidgetItem::CustomListWidgetItem(QPointer<SimpleCalendarCreator> mainWindow, const QString& label,
     std::unique_ptr<element::Element> object):
         mainWindow(mainWindow), QListWidgetItem(label), object(std::move(object))
@@ -37,6 +39,7 @@ CustomListWidgetItem::~CustomListWidgetItem() noexcept
 void CustomListWidgetItem::setElement(std::unique_ptr<element::Element> value) noexcept
 {
     this->object = std::move(value);
+    changeStamp = ++CustomListWidgetItem::lastChangeStamp;
     this->object->setParent(this);
 }
 
@@ -64,13 +67,39 @@ void CustomListWidgetItem::renderOutline()
 {
     if (object == nullptr) return;
 
-    QGraphicsView* winOutline{ mainWindow->getUi()->winOutline };
-    QGraphicsScene* scene{ winOutline->scene() };
+    outlineDirty = true;
+    mainWindow->scheduleOutlineUpdate();
+}
+
+void CustomListWidgetItem::markChanged() noexcept
+{
+    changeStamp = ++CustomListWidgetItem::lastChangeStamp;
+}
+
+std::uint64_t CustomListWidgetItem::getChangeStamp() const noexcept
+{
+    return changeStamp;
+}
+
+void CustomListWidgetItem::updateOutline()
+{
+    if (object == nullptr || !outlineDirty) return;
+    outlineDirty = false;
+
+    const element::OutlineGraphic& graphic{ object->getRenderedGraphics() };
     if (pixmapItem != nullptr)
     {
-        scene->removeItem(pixmapItem);
-        delete pixmapItem;
+        //Update the item in place, it keeps its place in the scene and only its old and new bounds are
+        //repainted.
+        if (pixmapItem->pixmap().cacheKey() != graphic.getPixmap().cacheKey())
+            pixmapItem->setPixmap(graphic.getPixmap());
+        if (pixmapItem->offset() != graphic.getOffset())
+            pixmapItem->setOffset(graphic.getOffset());
+        return;
     }
-    pixmapItem = new QGraphicsPixmapItem{ object->getRenderedGraphics() };
-    scene->addItem(pixmapItem);
+
+    QGraphicsView* winOutline{ mainWindow->getUi()->winOutline };
+    pixmapItem = new QGraphicsPixmapItem{ graphic.getPixmap() };
+    pixmapItem->setOffset(graphic.getOffset());
+    winOutline->scene()->addItem(pixmapItem);
 }
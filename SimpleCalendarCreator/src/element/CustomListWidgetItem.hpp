@@ -4,6 +4,7 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #pragma once
+#include <cstdint>
 #include <memory>
 
 #include <qpointer.h>
@@ -38,10 +39,31 @@ public:
     const QGraphicsPixmapItem* getPixmapItem() const noexcept;
 
     /**
-     * Render the outline of this item to the outline window.
+     * Mark the outline of this item dirty. Dirty outlines are rendered to the outline window in batches once
+     * the control returns to the event loop, see SimpleCalendarCreator::scheduleOutlineUpdate().
      */
     void renderOutline();
+    /**
+     * Render the outline of this item to the outline window if it is dirty. The graphics item is created on
+     * first render and updated in place afterward, so it keeps its stacking order in the scene.
+     */
+    void updateOutline();
+    /**
+     * Renew the change stamp after the properties of the element are changed by a command. Redrawing the
+     * outline alone, such as after the calendar is resized, is not a change.
+     */
+    void markChanged() noexcept;
+    /**
+     * Get the stamp of the last change to the element, renewed by markChanged() and setElement(). Stamps
+     * increase across all items, so an item created later always has a newer stamp.
+     */
+    std::uint64_t getChangeStamp() const noexcept;
 private:
+    /**
+     * @internal
+     * Stamp given to the last change of any item.
+     */
+    static std::uint64_t lastChangeStamp;
     /**
      * @internal
      * Reference to main window for rendering design outline, can't be nullptr.
@@ -62,4 +84,14 @@ private:
      * Memory of pixmapItem will be freed at the end if it does not own a parent.
      */
     QGraphicsPixmapItem* pixmapItem{ nullptr };
+    /**
+     * @internal
+     * Determine if the outline is changed since last updateOutline().
+     */
+    bool outlineDirty{ false };
+    /**
+     * @internal
+     * Stamp of the last change to the element.
+     */
+    std::uint64_t changeStamp{ ++CustomListWidgetItem::lastChangeStamp };
 };
\ No newline at end of file
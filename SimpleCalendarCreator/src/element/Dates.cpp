@@ -8,11 +8,16 @@
 #include <algorithm>
 #include <array>
 #include <map>
+#include <tuple>
 #include <vector>
 
 #include <QDate>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
+#include "render/TextLayoutCache.hpp"
 #include "window/object_editor/EditDates.hpp"
 
 #ifdef _DEBUG
@@ -32,35 +37,63 @@ namespace element
             QRect{},
             {}
         };
+        compileMarkers();
     }
     
     void Dates::setParent(CustomListWidgetItem* parent)
     {
         BOOST_ASSERT_MSG(parent != nullptr, "parent must not be nullptr");
         this->parent = parent;
+        drawOutline();
     }
     
     void Dates::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& Dates::getRenderedGraphics()
+    const OutlineGraphic& Dates::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap Dates::render(const QDate& date)
+    void Dates::paint(QPainter* painter, const QDate& date) const
+    {
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing, false);
+        painter->setRenderHint(QPainter::RenderHint::TextAntialiasing);
+        drawLabels(painter, date);
+        painter->restore();
+    }
+
+    bool Dates::isDateDependent() const
+    {
+        return true;
+    }
+
+    PropertiesHash Dates::hash(const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &rendered };
-        painter.setRenderHint(QPainter::RenderHint::TextAntialiasing);
-        drawLabels(&painter, date);
-        return rendered;
+        PropertiesHash seed{ hashOf(properties.textAlign, properties.weakdayColour, properties.weakendColour,
+            properties.weakstartColour, properties.font, properties.drawArea) };
+
+        //Only markers of the selected month affect its output.
+        QDate firstDay{ Dates::leap_reference_year, date.month(), 1 };
+        int firstIndex{ firstDay.dayOfYear() - 1 };
+        int lastIndex{ firstIndex + firstDay.daysInMonth() };
+        for (int day{ firstIndex }; day < lastIndex; day++)
+            hashCombine(seed, markerIndex.offsets[day] - markerIndex.offsets[firstIndex]);
+        for (int idx{ markerIndex.offsets[firstIndex] }; idx < markerIndex.offsets[lastIndex]; idx++)
+            hashCombine(seed, markerIndex.colours[markerIndex.markers[idx]]);
+        return seed;
+    }
+
+    std::unique_ptr<Element> Dates::clone() const
+    {
+        auto copy = std::make_unique<Dates>();
+        copy->properties = properties;
+        copy->markerIndex = markerIndex;
+        return copy;
     }
 
     void Dates::edit(QWidget* parent)
@@ -68,7 +101,10 @@ namespace element
         auto dialog = std::make_unique<EditDates>(&properties, parent);
         QString title{ dialog->windowTitle().arg(this->parent->text()) };
         dialog->setWindowTitle(title);
-        dialog->forwardConnect(std::bind(&Dates::drawOutline, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            onPropertiesChanged();
+        });
         dialog->exec();
     }
     
@@ -145,20 +181,159 @@ namespace element
             properties.speacialDays.emplace_back(std::move(name), std::move(colour), std::move(members));
         }
         properties.speacialDays.shrink_to_fit();
+        onPropertiesChanged();
+    }
+
+    void Dates::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.weakdayColour << properties.weakendColour << properties.weakstartColour
+            << properties.font << properties.drawArea << properties.textAlign;
+
+        *writer << static_cast<quint32>(properties.speacialDays.size());
+        for (const auto& itr : properties.speacialDays)
+        {
+            using TupleItem = element::object_properties::Dates::SpeacialDaysIndex;
+            const auto& members = std::get<TupleItem::group_members>(itr);
+            // Colours are stored as typed colour, text that isn't a valid colour is kept as is.
+            const QString& colourName{ std::get<TupleItem::group_colour>(itr) };
+            QColor colour{ colourName };
+            *writer << std::get<TupleItem::group_name>(itr) << colour;
+            if (!colour.isValid())
+                *writer << colourName;
+            *writer << static_cast<quint32>(members.size());
+            for (const auto& [name, date] : members)
+            {
+                // Dates are stored as typed date, text that isn't a valid date is kept as is.
+                QDate eventDate{ QDate::fromString(
+                    QString{ "%1-%2" }.arg(Dates::leap_reference_year).arg(date), "yyyy-MM-dd") };
+                *writer << name << eventDate;
+                if (!eventDate.isValid())
+                    *writer << date;
+            }
+        }
+    }
+
+    void Dates::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        quint32 groupCount{ 0 };
+        *reader >> properties.weakdayColour >> properties.weakendColour >> properties.weakstartColour
+            >> properties.font >> properties.drawArea >> properties.textAlign >> groupCount;
+
+        for (quint32 idx{ 0 }; idx < groupCount; idx++)
+        {
+            QString name;
+            QColor groupColour;
+            QString colour;
+            quint32 memberCount{ 0 };
+            *reader >> name >> groupColour;
+            if (groupColour.isValid())
+                colour = groupColour.name(QColor::NameFormat::HexArgb);
+            else
+                *reader >> colour;
+            *reader >> memberCount;
+
+            std::vector<std::pair<QString, QString>> members;
+            for (quint32 idx2{ 0 }; idx2 < memberCount; idx2++)
+            {
+                QString eventName;
+                QDate eventDate;
+                *reader >> eventName >> eventDate;
+
+                QString date;
+                if (eventDate.isValid())
+                    date = eventDate.toString("MM-dd");
+                else
+                    *reader >> date;
+                members.emplace_back(std::move(eventName), std::move(date));
+            }
+            members.shrink_to_fit();
+            properties.speacialDays.emplace_back(std::move(name), std::move(colour), std::move(members));
+        }
+        properties.speacialDays.shrink_to_fit();
+        onPropertiesChanged();
+    }
+
+    void Dates::onPropertiesChanged()
+    {
+        compileMarkers();
         drawOutline();
     }
+
+    void Dates::compileMarkers()
+    {
+        MarkerIndex index;
+        index.offsets.fill(0);
+        index.colours.reserve(properties.speacialDays.size());
+
+        std::vector<std::pair<int, int>> events;  //Day of leap year (0 based) => group index.
+        for (const auto& itr : properties.speacialDays)
+        {
+            using _Members = object_properties::Dates::SpeacialDaysIndex;
+            index.colours.emplace_back(std::get<_Members::group_colour>(itr));
+            for (const auto& [name, dateStr] : std::get<_Members::group_members>(itr))
+            {
+                QDate eventDate{ QDate::fromString(QString{ "%1-%2" }.arg(Dates::leap_reference_year)
+                    .arg(dateStr), "yyyy-MM-dd") };
+                if (!eventDate.isValid()) continue;
+                events.emplace_back(eventDate.dayOfYear() - 1, static_cast<int>(index.colours.size() - 1));
+            }
+        }
+
+        //Counting sort by day, markers of the same day keep the order of the groups.
+        for (const auto& [day, group] : events)
+            index.offsets[day + 1]++;
+        for (std::size_t idx{ 1 }; idx < index.offsets.size(); idx++)
+            index.offsets[idx] += index.offsets[idx - 1];
+
+        index.markers.resize(events.size());
+        auto cursor = index.offsets;
+        for (const auto& [day, group] : events)
+            index.markers[cursor[day]++] = group;
+
+        markerIndex = std::move(index);
+    }
     
     void Dates::drawOutline()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
+        if (parent == nullptr) return;
+
         QDate date{ QDate::currentDate().year(), 1, 1 };
-        painter.fillRect(properties.drawArea, QColor{ Dates::outline_bound_colour });
-        drawLabels(&painter, date);
+        graphic.draw([this, date](QPainter* painter) {
+            painter->fillRect(properties.drawArea, QColor{ Dates::outline_bound_colour });
+            drawLabels(painter, date);
+        });
         parent->renderOutline();
     }
     
-    void Dates::drawLabels(QPainter* painter, const QDate& date)
+    const QPainterPath& Dates::getMarkerSlice(qreal radius, int count, int index)
+    {
+        using Key = std::tuple<qreal, int, int>;
+        thread_local std::map<Key, QPainterPath> slices;
+
+        Key key{ radius, count, index };
+        auto itr = slices.find(key);
+        if (itr != slices.end())
+            return itr->second;
+
+        if (slices.size() >= Dates::max_cached_marker_slices)
+            slices.clear();
+
+        int sliceWidth{ static_cast<int>((radius * 2) / count) };
+        QPoint markerPos{ -static_cast<int>(radius), -static_cast<int>(radius) };
+        QPainterPath ellipse;
+        QPainterPath lhs;
+        QPainterPath rhs;
+        ellipse.addEllipse(QPointF{ 0, 0 }, radius, radius);
+        lhs.addRect(markerPos.x(), markerPos.y(), sliceWidth * index, 2 * radius);
+        rhs.addRect(markerPos.x() + (sliceWidth * (index + 1)), markerPos.y(),
+            sliceWidth * (count - index - 1), 2 * radius);
+
+        return slices.emplace(key, ellipse - lhs - rhs).first->second;
+    }
+
+    void Dates::drawLabels(QPainter* painter, const QDate& date) const
     {
 #ifdef _DEBUG
         qDebug() << date.toString(Qt::DateFormat::ISODate);
@@ -168,23 +343,6 @@ namespace element
         if (weakend <= 0)
             weakend = 7;
 
-        std::vector<QColor> colours;
-        std::multimap<QDate, int> eventsList;
-
-        colours.reserve(properties.speacialDays.size());
-
-        for (const auto& itr : properties.speacialDays)
-        {
-            using _Members = object_properties::Dates::SpeacialDaysIndex;
-            colours.emplace_back(std::get<_Members::group_colour>(itr));
-            for (const auto& [name, dateStr] : std::get<_Members::group_members>(itr))
-            {
-                QDate eventDate{ QDate::fromString(dateStr, "MM-dd") };
-                eventDate.setDate(date.year(), eventDate.month(), eventDate.day());
-                eventsList.emplace(std::move(eventDate), colours.size() - 1);
-            }
-        }
-
         QPen pen;
         QDate calendar{ date };
         int textAlignFlags = Qt::AlignmentFlag::AlignVCenter;
@@ -211,6 +369,7 @@ namespace element
         int y{ properties.drawArea.y() };
         int w{ properties.drawArea.width() / 7 };
         int h{ properties.drawArea.height() / 5 };
+        qreal markerRadius{ (std::min(w, h) / 2.0) * .8 };
         while (calendar.month() == date.month())
         {
             auto shift = shifter[calendar.dayOfWeek() - 1];
@@ -221,33 +380,25 @@ namespace element
             else
                 pen.setColor(properties.weakdayColour);
 
-            auto range = eventsList.equal_range(calendar);
-            int counter{ 0 };
-            int size{ std::distance(range.first, range.second) };
-            qreal markerRadius{ (std::min(w, h) / 2.0) * .8 };
-            int minMarkerWidth{ static_cast<int>((markerRadius * 2) / size) };
-
-            QPoint markerCenter{ x + (shift * w) + (w / 2), y + (h / 2) };
-            QPoint markerPos{ markerCenter
-                - QPoint{ static_cast<int>(markerRadius), static_cast<int>(markerRadius) } };
-            QPainterPath ellipse;
-            ellipse.addEllipse(markerCenter, markerRadius, markerRadius);
-            
-            for (auto itr = range.first; itr != range.second; ++itr)
+            QDate leapDate{ Dates::leap_reference_year, calendar.month(), calendar.day() };
+            int dayIndex{ leapDate.dayOfYear() - 1 };
+            int firstMarker{ markerIndex.offsets[dayIndex] };
+            int size{ markerIndex.offsets[dayIndex + 1] - firstMarker };
+            if (size > 0)
             {
-                QPainterPath lhs;
-                QPainterPath rhs;
-
-                lhs.addRect(markerPos.x(), markerPos.y(), minMarkerWidth * counter, 2 * markerRadius);
-                rhs.addRect(markerPos.x() + (minMarkerWidth * (counter + 1)), markerPos.y(),
-                    minMarkerWidth * (size - counter - 1), 2 * markerRadius);
-
-                painter->fillPath(ellipse - lhs - rhs, colours[itr->second]);
-                counter++;
+                QPoint markerCenter{ x + (shift * w) + (w / 2), y + (h / 2) };
+                painter->translate(markerCenter);
+                for (int counter{ 0 }; counter < size; counter++)
+                {
+                    painter->fillPath(getMarkerSlice(markerRadius, size, counter),
+                        markerIndex.colours[markerIndex.markers[firstMarker + counter]]);
+                }
+                painter->translate(-markerCenter);
             }
 
             painter->setPen(pen);
-            painter->drawText(x + (shift * w), y, w, h, textAlignFlags, QString::number(calendar.day()));
+            render::TextLayoutCache::drawText(painter, QRect{ x + (shift * w), y, w, h }, textAlignFlags,
+                QString::number(calendar.day()));
 
             if (shift == shifter[weakend - 1])  //Determine if weakend
                 y += h;
@@ -4,11 +4,13 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #pragma once
+#include <array>
 #include <tuple>
 #include <vector>
 
 #include <QColor>
 #include <QFont>
+#include <QPainterPath>
 
 #include "element/Element.hpp"
 
@@ -70,31 +72,72 @@ namespace element
     public:
         /** Background colour of outline bound in AARRGGBB format. */
         static constexpr char* const outline_bound_colour{ "#4c87ceeb" };
+        /** Leap year used to index speacial days by day of year, so that 29 February has its own slot. */
+        static constexpr int leap_reference_year{ 2000 };
+        /** Maximum amount of marker slices kept by each thread, the cache is cleared when exceeded. */
+        static constexpr std::size_t max_cached_marker_slices{ 256 };
     public:
         /** Create new object with default properties. */
         Dates();
 
         void setParent(CustomListWidgetItem* parent) override;
         void setSize(const QSize& size) override;
-        const QPixmap& getRenderedGraphics() override;
-        QPixmap render(const QDate& date) override;
+        const OutlineGraphic& getRenderedGraphics() override;
+        void paint(QPainter* painter, const QDate& date) const override;
+        bool isDateDependent() const override;
+        PropertiesHash hash(const QDate& date) const override;
+        std::unique_ptr<Element> clone() const override;
         void edit(QWidget* parent = nullptr) override;
         void serialize(pugi::xml_node* node) override;
         void deserialize(const pugi::xml_node& node) override;
+        void serialize(project::DesignWriter* writer) override;
+        void deserialize(project::DesignReader* reader) override;
 
     private:
+        /**
+         * @internal
+         * Speacial days compiled from properties for lookup without allocation while drawing.
+         */
+        struct MarkerIndex
+        {
+            std::vector<QColor> colours;  /**< Parsed colour of each markers group. */
+            std::vector<int> markers;  /**< Group index of each marker, grouped by day of leap year. */
+            /** Markers of day n (0 based) of leap year are markers[offsets[n]] to markers[offsets[n + 1]]. */
+            std::array<int, 367> offsets;
+        };
+
+    private:
+        /**
+         * @internal
+         * Rebuild the compiled speacial days and redraw the outline, called when properties changed.
+         */
+        void onPropertiesChanged();
+        /**
+         * @internal
+         * Compile speacial days of the properties into markerIndex.
+         */
+        void compileMarkers();
         /**
          * @internal
          * Render graphic for outline.
          */
         void drawOutline();
+        /**
+         * @internal
+         * Get the slice of a speacial day marker, relative to the marker's center. Slices are computed once
+         * per thread and reused by all days and months, as QPainterPath must not be shared between threads.
+         * @param radius Radius of the marker.
+         * @param count Amount of events on the day.
+         * @param index Index of the event on the day.
+         */
+        static const QPainterPath& getMarkerSlice(qreal radius, int count, int index);
         /**
          * @internal
          * Generic rendering function.
          * @param painter Painter to draw with, must not be nullptr.
          * @param date Selected date to draw, used year and month only.
          */
-        void drawLabels(QPainter* painter, const QDate& date);
+        void drawLabels(QPainter* painter, const QDate& date) const;
 
     private:
         /**
@@ -107,10 +150,15 @@ namespace element
          * Properties of Dates.
          */
         object_properties::Dates properties;
+        /**
+         * @internal
+         * Compiled speacial days of properties.
+         */
+        MarkerIndex markerIndex;
         /**
          * @internal
          * Rendered graphic for outline.
          */
-        QPixmap graphic;
+        OutlineGraphic graphic;
     };
 }
\ No newline at end of file
@@ -4,18 +4,29 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #pragma once
+#include <memory>
 #include <string>
 #include <type_traits>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/type_index.hpp>
 
+#include <qpainter.h>
 #include <qpixmap.h>
 
 #include <pugixml.hpp>
 
+#include "element/OutlineGraphic.hpp"
+#include "element/PropertiesHash.hpp"
+
 class CustomListWidgetItem;
 
+namespace project
+{
+    class DesignReader;
+    class DesignWriter;
+}
+
 namespace element
 {
     /**
@@ -29,7 +40,9 @@ namespace element
     {
     public:
         /**
-         * Set parent of the element.
+         * Set parent of the element and draw its outline for the parent. Element without parent skips the
+         * rendering of its outline, which is the case of elements loaded for headless rendering or on a
+         * worker thread.
          */
         virtual void setParent(CustomListWidgetItem* parent) = 0;
         /**
@@ -37,13 +50,32 @@ namespace element
          */
         virtual void setSize(const QSize& value) = 0;
         /**
-         * Get the rendered graphics for outline purpose.
+         * Get the rendered graphics for outline purpose, which covers only the area drawn by the element.
+         */
+        virtual const OutlineGraphic& getRenderedGraphics() = 0;
+        /**
+         * Paint the selected month in a year directly on the caller's canvas.
+         * @param painter Active painter of the month's canvas, must not be nullptr. Its state is restored
+         * before returning.
+         * @param date Selected date to draw, used year and month only.
          */
-        virtual const QPixmap& getRenderedGraphics() = 0;
+        virtual void paint(QPainter* painter, const QDate& date) const = 0;
         /**
-         * Render the selected month in a year.
+         * Determine if the output of paint() depends on the date. Date-invariant elements are rendered once
+         * and reused for every month.
          */
-        virtual QPixmap render(const QDate& date) = 0;
+        virtual bool isDateDependent() const = 0;
+        /**
+         * Get the hash of everything that affects paint() for the month of the selected date. A month
+         * painted with the same hash is the same image. The hash is stable across runs, see PropertiesHash.
+         * @param date Selected date, used year and month only.
+         */
+        virtual PropertiesHash hash(const QDate& date) const = 0;
+        /**
+         * Create a copy of the element that holds only its properties, without parent or outline graphic.
+         * The copy is safe to paint on worker threads while the user keeps editing the original.
+         */
+        virtual std::unique_ptr<Element> clone() const = 0;
         /**
          * Allow user to modifide the properties of the element.
          * @param parent Parent of edit dialog, nullptr for no parent.
@@ -56,10 +88,22 @@ namespace element
          */
         virtual void serialize(pugi::xml_node* node) = 0;
         /**
-         * Deserialize data from save file.
+         * Deserialize data from save file, the outline is marked dirty if the element has a parent and
+         * rasterized lazily.
          * @param node XML node that contain Calendar Object's properties.
          */
         virtual void deserialize(const pugi::xml_node& node) = 0;
+        /**
+         * Serialize data for the compact binary design, into the record started by the caller.
+         * @param writer Writer of the binary design, can't be nullptr.
+         */
+        virtual void serialize(project::DesignWriter* writer) = 0;
+        /**
+         * Deserialize data from the compact binary design, the outline is marked dirty if the element has a
+         * parent and rasterized lazily.
+         * @param reader Reader positioned at the record of the element, can't be nullptr.
+         */
+        virtual void deserialize(project::DesignReader* reader) = 0;
         virtual ~Element() noexcept = 0;
 
         /**
@@ -75,6 +119,16 @@ namespace element
             boost::replace_first(name, "class ", "");
             return name;
         }
+        /**
+         * Get class name of the given calendar object, same as getTypeName<T>() of its dynamic type.
+         * @param object Calendar object to find class name.
+         */
+        static inline std::string getTypeName(const Element& object)
+        {
+            std::string name{ boost::typeindex::type_id_runtime(object).pretty_name() };
+            boost::replace_first(name, "class ", "");
+            return name;
+        }
     };
     inline Element::~Element() = default;
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <boost/assert.hpp>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditEllipse.hpp"
 
 namespace element
@@ -28,44 +31,60 @@ namespace element
     {
         BOOST_ASSERT_MSG(parent != nullptr, "parent must not be nullptr");
         this->parent = parent;
+        drawEllipse();
     }
     
     void Ellipse::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& Ellipse::getRenderedGraphics()
+    const OutlineGraphic& Ellipse::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap Ellipse::render(const QDate& date)
+    void Ellipse::paint(QPainter* painter, const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-
-        QPainter painter{ &rendered };
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
         QPen pen{ { properties.foregroundColour }, static_cast<qreal>(properties.width) };
-        painter.setPen(pen);
-        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+        painter->setPen(pen);
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing);
 
         QPainterPath path;
         path.addEllipse(properties.originPos, static_cast<qreal>(properties.radiusX),
             static_cast<qreal>(properties.radiusY));
-        painter.fillPath(path, { properties.backgroundColour });
-        painter.drawPath(path);
-
-        return rendered;
+        painter->fillPath(path, { properties.backgroundColour });
+        painter->drawPath(path);
+        painter->restore();
+    }
+    
+    bool Ellipse::isDateDependent() const
+    {
+        return false;
     }
     
+    PropertiesHash Ellipse::hash(const QDate& date) const
+    {
+        return hashOf(properties.radiusX, properties.radiusY, properties.width, properties.originPos,
+            properties.foregroundColour, properties.backgroundColour);
+    }
+    
+    std::unique_ptr<Element> Ellipse::clone() const
+    {
+        auto copy = std::make_unique<Ellipse>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void Ellipse::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditEllipse>(&properties, parent);
-        dialog->forwardConnect(std::bind(&Ellipse::drawEllipse, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawEllipse();
+        });
         
         QString title{ dialog->windowTitle() };
         dialog->setWindowTitle(title.arg(this->parent->text()));
@@ -114,20 +133,36 @@ namespace element
         drawEllipse();
     }
 
+    void Ellipse::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.width << properties.originPos << properties.radiusX << properties.radiusY
+            << properties.foregroundColour << properties.backgroundColour;
+    }
+
+    void Ellipse::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        *reader >> properties.width >> properties.originPos >> properties.radiusX >> properties.radiusY
+            >> properties.foregroundColour >> properties.backgroundColour;
+        drawEllipse();
+    }
+
     void Ellipse::drawEllipse()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
+        if (parent == nullptr) return;
 
-        QPainter painter{ &graphic };
-        QPen pen{ { properties.foregroundColour }, static_cast<qreal>(properties.width) };
+        graphic.draw([this](QPainter* painter) {
+            QPen pen{ { properties.foregroundColour }, static_cast<qreal>(properties.width) };
 
-        QPainterPath path;
-        path.addEllipse(properties.originPos, static_cast<qreal>(properties.radiusX),
-            static_cast<qreal>(properties.radiusY));
+            QPainterPath path;
+            path.addEllipse(properties.originPos, static_cast<qreal>(properties.radiusX),
+                static_cast<qreal>(properties.radiusY));
 
-        painter.setPen(pen);
-        painter.fillPath(path, { properties.backgroundColour });
-        painter.drawPath(path);
+            painter->setPen(pen);
+            painter->fillPath(path, { properties.backgroundColour });
+            painter->drawPath(path);
+        });
         parent->renderOutline();
     }
 }
\ No newline at end of file
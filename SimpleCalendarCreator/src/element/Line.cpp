@@ -4,6 +4,7 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
 
 #include <algorithm>
 #include <functional>
@@ -23,6 +24,8 @@
 #include <qspinbox.h>
 
 #include "element/Line.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditLine.hpp"
 
 #ifdef _DEBUG
@@ -42,43 +45,59 @@ namespace element
     void Line::setParent(CustomListWidgetItem* parent)
     {
         this->parent = parent;
-        graphic = QPixmap{};
+        graphic.clear();
+        drawLine();
     }
 
     void Line::setSize(const QSize& value)
     {
-        if (graphic.size().isNull())
-            graphic = QPixmap{ value };
-        else
-            graphic.scaled(value);
+        graphic.setCanvasSize(value);
     }
 
-    const QPixmap& Line::getRenderedGraphics()
+    const OutlineGraphic& Line::getRenderedGraphics()
     {
         return graphic;
     }
 
-    QPixmap Line::render(const QDate& date)
+    void Line::paint(QPainter* painter, const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-
-        QPainter painter{ &rendered };
-        QPen pen{ painter.pen() };
-        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+        BOOST_ASSERT_MSG(painter != nullptr, "painter can't be nullptr");
+        painter->save();
+        QPen pen{ painter->pen() };
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing);
         pen.setWidth(properties.lineWidth);
         pen.setColor(properties.lineColour);
-        painter.setPen(pen);
+        painter->setPen(pen);
+
+        painter->drawLine(properties.posLineStart, properties.posLineEnd);
+        painter->restore();
+    }
+
+    bool Line::isDateDependent() const
+    {
+        return false;
+    }
 
-        painter.drawLine(properties.posLineStart, properties.posLineEnd);
+    PropertiesHash Line::hash(const QDate& date) const
+    {
+        return hashOf(properties.lineWidth, properties.posLineStart, properties.posLineEnd,
+            properties.lineColour);
+    }
 
-        return rendered;
+    std::unique_ptr<Element> Line::clone() const
+    {
+        auto copy = std::make_unique<Line>();
+        copy->properties = properties;
+        return copy;
     }
 
     void Line::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditLine>(&properties, parent);
-        dialog->forwardConnect(std::bind(&Line::drawLine, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawLine();
+        });
         auto dialogWindowTitle = dialog->windowTitle();
         dialog->setWindowTitle(dialogWindowTitle.arg(this->parent->text()));
         dialog->exec();
@@ -122,15 +141,32 @@ namespace element
         drawLine();
     }
 
+    void Line::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer can't be nullptr");
+        *writer << properties.lineColour << properties.lineWidth << properties.posLineStart
+            << properties.posLineEnd;
+    }
+
+    void Line::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader can't be nullptr");
+        *reader >> properties.lineColour >> properties.lineWidth >> properties.posLineStart
+            >> properties.posLineEnd;
+        drawLine();
+    }
+
     void Line::drawLine()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
-        QPen pen = painter.pen();
-        pen.setColor(properties.lineColour);
-        pen.setWidth(properties.lineWidth);
-        painter.setPen(pen);
-        painter.drawLine(properties.posLineStart, properties.posLineEnd);
+        if (parent == nullptr) return;
+
+        graphic.draw([this](QPainter* painter) {
+            QPen pen = painter->pen();
+            pen.setColor(properties.lineColour);
+            pen.setWidth(properties.lineWidth);
+            painter->setPen(pen);
+            painter->drawLine(properties.posLineStart, properties.posLineEnd);
+        });
         parent->renderOutline();
     }
 }
\ No newline at end of file
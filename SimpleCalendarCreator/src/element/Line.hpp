@@ -57,11 +57,16 @@ namespace element
         Line();
         void setParent(CustomListWidgetItem* parent) override;
         void setSize(const QSize& value) override;
-        const QPixmap& getRenderedGraphics() override;
-        QPixmap render(const QDate& date) override;
+        const OutlineGraphic& getRenderedGraphics() override;
+        void paint(QPainter* painter, const QDate& date) const override;
+        bool isDateDependent() const override;
+        PropertiesHash hash(const QDate& date) const override;
+        std::unique_ptr<Element> clone() const override;
         void edit(QWidget* parent = nullptr) override;
         void serialize(pugi::xml_node* node) override;
         void deserialize(const pugi::xml_node& node) override;
+        void serialize(project::DesignWriter* writer) override;
+        void deserialize(project::DesignReader* reader) override;
     private:
         /**
          * @internal
@@ -73,7 +78,7 @@ namespace element
          * @internal
          * Parent object that holding the element.
          */
-        CustomListWidgetItem* parent;
+        CustomListWidgetItem* parent{ nullptr };
         /**
          * @internal
          * Common properties of line object.
@@ -83,6 +88,6 @@ namespace element
          * @internal
          * Pre-rendered graphics that use as outline of the design.
          */
-        QPixmap graphic;
+        OutlineGraphic graphic;
     };
 }
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include <QDate>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditMonthTitle.hpp"
 
 namespace element
@@ -31,39 +34,56 @@ namespace element
     {
         BOOST_ASSERT_MSG(parent != nullptr, "parent must not be nullptr");
         this->parent = parent;
+        drawOutline();
     }
     
     void MonthTitle::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& MonthTitle::getRenderedGraphics()
+    const OutlineGraphic& MonthTitle::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap MonthTitle::render(const QDate& date)
+    void MonthTitle::paint(QPainter* painter, const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-
-        QPainter painter{ &rendered };
-        painter.setRenderHint(QPainter::RenderHint::TextAntialiasing);
-        drawTitle(&painter, date);
-
-        return rendered;
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing, false);
+        painter->setRenderHint(QPainter::RenderHint::TextAntialiasing);
+        drawTitle(painter, date);
+        painter->restore();
     }
     
+    bool MonthTitle::isDateDependent() const
+    {
+        return true;
+    }
+    
+    PropertiesHash MonthTitle::hash(const QDate& date) const
+    {
+        return hashOf(properties.isVertical, properties.textAlign, properties.nameFormat, properties.locale,
+            properties.pos, properties.font, properties.textColour);
+    }
+    
+    std::unique_ptr<Element> MonthTitle::clone() const
+    {
+        auto copy = std::make_unique<MonthTitle>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void MonthTitle::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditMonthTitle>(&properties, parent);
         QString title{ dialog->windowTitle().arg(this->parent->text()) };
         dialog->setWindowTitle(title);
-        dialog->forwardConnect(std::bind(&MonthTitle::drawOutline, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawOutline();
+        });
         dialog->exec();
     }
     
@@ -108,17 +128,35 @@ namespace element
         drawOutline();
     }
 
+    void MonthTitle::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.nameFormat << properties.locale.name() << properties.pos << properties.font
+            << properties.textColour << properties.isVertical << properties.textAlign;
+    }
+
+    void MonthTitle::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        QString locale;
+        *reader >> properties.nameFormat >> locale >> properties.pos >> properties.font
+            >> properties.textColour >> properties.isVertical >> properties.textAlign;
+        properties.locale = QLocale{ locale };
+
+        drawOutline();
+    }
+
     void MonthTitle::drawOutline()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
+        if (parent == nullptr) return;
+
         auto date = QDate::currentDate();
         date.setDate(date.year(), 1, 1);
-        drawTitle(&painter, date);
+        graphic.draw([this, date](QPainter* painter) { drawTitle(painter, date); });
         parent->renderOutline();
     }
     
-    void MonthTitle::drawTitle(QPainter* painter, const QDate& date)
+    void MonthTitle::drawTitle(QPainter* painter, const QDate& date) const
     {
         QPen pen{ properties.textColour };
         painter->setPen(pen);
@@ -72,11 +72,16 @@ namespace element
 
         void setParent(CustomListWidgetItem* parent) override;
         void setSize(const QSize& size) override;
-        const QPixmap& getRenderedGraphics() override;
-        QPixmap render(const QDate& date) override;
+        const OutlineGraphic& getRenderedGraphics() override;
+        void paint(QPainter* painter, const QDate& date) const override;
+        bool isDateDependent() const override;
+        PropertiesHash hash(const QDate& date) const override;
+        std::unique_ptr<Element> clone() const override;
         void edit(QWidget* parent = nullptr) override;
         void serialize(pugi::xml_node* node) override;
         void deserialize(const pugi::xml_node& node) override;
+        void serialize(project::DesignWriter* writer) override;
+        void deserialize(project::DesignReader* reader) override;
 
     private:
         /**
@@ -90,7 +95,7 @@ namespace element
          * @param painter Painter to draw on, must not be nullptr.
          * @param date Render month in the selected date.
          */
-        void drawTitle(QPainter* painter, const QDate& date);
+        void drawTitle(QPainter* painter, const QDate& date) const;
 
     private:
         /**
@@ -107,6 +112,6 @@ namespace element
          * @internal
          * Graphic that use to render the outline of the Calendar Object.
          */
-        QPixmap graphic;
+        OutlineGraphic graphic;
     };
 }
\ No newline at end of file
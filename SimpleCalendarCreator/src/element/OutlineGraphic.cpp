@@ -0,0 +1,86 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "element/OutlineGraphic.hpp"
+
+#include <boost/assert.hpp>
+
+#include <QPicture>
+#include <QRect>
+
+namespace element
+{
+    void OutlineGraphic::setCanvasSize(const QSize& value)
+    {
+        canvasSize = value;
+    }
+
+    const QPixmap& OutlineGraphic::getPixmap() const
+    {
+        if (dirty) rasterize();
+        return pixmap;
+    }
+
+    const QPoint& OutlineGraphic::getOffset() const
+    {
+        if (dirty) rasterize();
+        return offset;
+    }
+
+    bool OutlineGraphic::isDirty() const noexcept
+    {
+        return dirty;
+    }
+
+    void OutlineGraphic::draw(const std::function<void(QPainter*)>& drawer)
+    {
+        BOOST_ASSERT_MSG(drawer != nullptr, "drawer must not be nullptr");
+        this->drawer = drawer;
+        dirty = true;
+    }
+
+    void OutlineGraphic::clear()
+    {
+        drawer = nullptr;
+        dirty = false;
+        pixmap = QPixmap{};
+        offset = QPoint{};
+    }
+
+    void OutlineGraphic::rasterize() const
+    {
+        BOOST_ASSERT_MSG(drawer != nullptr, "drawer must not be nullptr");
+        dirty = false;
+
+        //Record the drawing first to find its bounds, QPicture include the width of pens in its bounds.
+        QPicture recorder;
+        {
+            QPainter painter{ &recorder };
+            drawer(&painter);
+        }
+        QRect drawn{ recorder.boundingRect() };
+        QRect bounds;
+        if (!drawn.isNull())
+        {
+            bounds = drawn.adjusted(-OutlineGraphic::bounds_margin, -OutlineGraphic::bounds_margin,
+                OutlineGraphic::bounds_margin, OutlineGraphic::bounds_margin) &
+                QRect{ QPoint{ 0, 0 }, canvasSize };
+        }
+
+        if (bounds.isEmpty())
+        {
+            pixmap = QPixmap{};
+            offset = QPoint{};
+            return;
+        }
+
+        offset = bounds.topLeft();
+        pixmap = QPixmap{ bounds.size() };
+        pixmap.fill(Qt::GlobalColor::transparent);
+        QPainter painter{ &pixmap };
+        painter.translate(-offset);
+        drawer(&painter);
+    }
+}
@@ -0,0 +1,94 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <functional>
+
+#include <QPainter>
+#include <QPixmap>
+#include <QPoint>
+#include <QSize>
+
+namespace element
+{
+    /**
+     * @brief Pre-rendered outline of an element, stored only over the area the element draws on.
+     *
+     * The pixmap covers the bounds of what is drawn, clipped to the calendar, and is placed on the calendar
+     * at getOffset(). Memory scales with the drawn area instead of the size of the calendar.
+     *
+     * Drawing is lazy, draw() only keep the drawer and the outline is rasterized on the next call of
+     * getPixmap() or getOffset(). Elements redrawn many times in a row, such as while loading a project, are
+     * rasterized once.
+     */
+    class OutlineGraphic
+    {
+    public:
+        /** Margin around the drawn bounds in pixels, for the antialiased edges. */
+        static constexpr int bounds_margin{ 1 };
+    public:
+        /**
+         * Set size of the calendar, nothing is drawn outside of it.
+         */
+        void setCanvasSize(const QSize& value);
+        /**
+         * Get the rendered outline, null if nothing is drawn. Rasterize the outline if it is dirty.
+         */
+        const QPixmap& getPixmap() const;
+        /**
+         * Get the position of the pixmap on the calendar. Rasterize the outline if it is dirty.
+         */
+        const QPoint& getOffset() const;
+        /**
+         * Determine if the outline is drawn but not rasterized yet.
+         */
+        bool isDirty() const noexcept;
+
+        /**
+         * Render the outline again, the outline is marked dirty until it is rasterized.
+         * @param drawer Function that draw the element in calendar coordinate, may be called more than once
+         * and after this function returned, so it must not capture local variables by reference.
+         */
+        void draw(const std::function<void(QPainter*)>& drawer);
+        /**
+         * Release the rendered outline.
+         */
+        void clear();
+
+    private:
+        /**
+         * @internal
+         * Rasterize the outline with the last drawer.
+         */
+        void rasterize() const;
+
+    private:
+        /**
+         * @internal
+         * Size of the calendar.
+         */
+        QSize canvasSize;
+        /**
+         * @internal
+         * Function that draw the element, nullptr if the outline is cleared.
+         */
+        std::function<void(QPainter*)> drawer;
+        /**
+         * @internal
+         * Determine if drawer is not rasterized yet.
+         */
+        mutable bool dirty{ false };
+        /**
+         * @internal
+         * Rendered outline over the drawn bounds.
+         */
+        mutable QPixmap pixmap;
+        /**
+         * @internal
+         * Position of pixmap on the calendar.
+         */
+        mutable QPoint offset;
+    };
+}
@@ -0,0 +1,115 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include <QColor>
+#include <QFont>
+#include <QLocale>
+#include <QPoint>
+#include <QRect>
+#include <QSize>
+#include <QString>
+
+namespace element
+{
+    /**
+     * @name Properties hashing
+     * Combine values of calendar objects' properties into a hash, used to detect changes of rendered output.
+     * The hash is computed by a fixed 64 bits algorithm rather than std::hash or qHash, so it's the same on
+     * every platform, compiler and Qt version and may be stored across runs.
+     * @{
+     */
+    /** Hash of calendar objects' properties. */
+    using PropertiesHash = std::uint64_t;
+
+    /**
+     * Mix a 64 bits word into the seed, with the finalizer of SplitMix64.
+     */
+    inline void mixHash(PropertiesHash& seed, std::uint64_t value) noexcept
+    {
+        std::uint64_t word{ seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2)) };
+        word = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9;
+        word = (word ^ (word >> 27)) * 0x94d049bb133111eb;
+        seed = word ^ (word >> 31);
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    inline void hashCombine(PropertiesHash& seed, T value)
+    {
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            double number{ static_cast<double>(value) };
+            std::uint64_t bits{ 0 };
+            std::memcpy(&bits, &number, sizeof(bits));
+            mixHash(seed, bits);
+        }
+        else
+        {
+            mixHash(seed, static_cast<std::uint64_t>(value));
+        }
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QString& value)
+    {
+        //FNV-1a over the UTF-16 code units.
+        std::uint64_t hash{ 0xcbf29ce484222325 };
+        for (QChar itr : value)
+        {
+            hash ^= itr.unicode();
+            hash *= 0x100000001b3;
+        }
+        mixHash(seed, hash);
+        mixHash(seed, static_cast<std::uint64_t>(value.size()));
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QColor& value)
+    {
+        mixHash(seed, value.rgba64());
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QFont& value)
+    {
+        hashCombine(seed, value.key());
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QLocale& value)
+    {
+        hashCombine(seed, value.bcp47Name());
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QPoint& value)
+    {
+        hashCombine(seed, value.x());
+        hashCombine(seed, value.y());
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QSize& value)
+    {
+        hashCombine(seed, value.width());
+        hashCombine(seed, value.height());
+    }
+
+    inline void hashCombine(PropertiesHash& seed, const QRect& value)
+    {
+        hashCombine(seed, value.topLeft());
+        hashCombine(seed, value.size());
+    }
+
+    /**
+     * Get the combined hash of all values.
+     */
+    template <typename... Args>
+    inline PropertiesHash hashOf(const Args&... values)
+    {
+        PropertiesHash seed{ 0 };
+        (hashCombine(seed, values), ...);
+        return seed;
+    }
+    /** @} */
+}
@@ -10,6 +10,9 @@
 #include <QPainter>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditRectangle.hpp"
 
 namespace element
@@ -25,44 +28,61 @@ namespace element
     void Rectangle::setParent(CustomListWidgetItem* parent)
     {
         this->parent = parent;
+        drawRect();
     }
     
     void Rectangle::setSize(const QSize& size)
     {
-        if (graphic.size().isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& Rectangle::getRenderedGraphics()
+    const OutlineGraphic& Rectangle::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap Rectangle::render(const QDate& date)
+    void Rectangle::paint(QPainter* painter, const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &rendered };
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
         QPen pen{ properties.foregroundColour, static_cast<qreal>(properties.width) };
-        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
-        painter.setPen(pen);
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing);
+        painter->setPen(pen);
 
         QPainterPath path;
         path.addRect(properties.rect);
-        painter.fillPath(path, { properties.backgroundColour });
-        painter.drawPath(path);
-
-        return rendered;
+        painter->fillPath(path, { properties.backgroundColour });
+        painter->drawPath(path);
+        painter->restore();
+    }
+    
+    bool Rectangle::isDateDependent() const
+    {
+        return false;
+    }
+    
+    PropertiesHash Rectangle::hash(const QDate& date) const
+    {
+        return hashOf(properties.rect, properties.foregroundColour, properties.backgroundColour,
+            properties.width);
     }
     
+    std::unique_ptr<Element> Rectangle::clone() const
+    {
+        auto copy = std::make_unique<Rectangle>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void Rectangle::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditRectangle>(&properties, parent);
         auto dialogTitle = dialog->windowTitle();
         dialog->setWindowTitle(dialogTitle.arg(this->parent->text()));
-        dialog->forwardConnect(std::bind(&Rectangle::drawRect, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawRect();
+        });
         dialog->exec();
     }
     
@@ -103,17 +123,34 @@ namespace element
         drawRect();
     }
     
+    void Rectangle::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.width << properties.backgroundColour << properties.foregroundColour
+            << properties.rect;
+    }
+    
+    void Rectangle::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        *reader >> properties.width >> properties.backgroundColour >> properties.foregroundColour
+            >> properties.rect;
+        drawRect();
+    }
+    
     void Rectangle::drawRect()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
-        QPen pen{ properties.foregroundColour, static_cast<qreal>(properties.width) };
-        painter.setPen(pen);
-        
-        QPainterPath path;
-        path.addRect(properties.rect);
-        painter.fillPath(path, { properties.backgroundColour });
-        painter.drawPath(path);
+        if (parent == nullptr) return;
+
+        graphic.draw([this](QPainter* painter) {
+            QPen pen{ properties.foregroundColour, static_cast<qreal>(properties.width) };
+            painter->setPen(pen);
+
+            QPainterPath path;
+            path.addRect(properties.rect);
+            painter->fillPath(path, { properties.backgroundColour });
+            painter->drawPath(path);
+        });
         parent->renderOutline();
     }
 }
\ No newline at end of file
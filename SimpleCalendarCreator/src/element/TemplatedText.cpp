@@ -13,7 +13,10 @@
 #include <QFontMetrics>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
 #include "element/Text.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditTemplatedText.hpp"
 
 namespace element
@@ -34,39 +37,64 @@ namespace element
     {
         BOOST_ASSERT_MSG(parent != nullptr, "parent must not be nullptr");
         this->parent = parent;
+        drawOutline();
     }
     
     void TemplatedText::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& TemplatedText::getRenderedGraphics()
+    const OutlineGraphic& TemplatedText::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap TemplatedText::render(const QDate& date)
+    void TemplatedText::paint(QPainter* painter, const QDate& date) const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-
-        QPainter painter{ &rendered };
-        painter.setRenderHint(QPainter::RenderHint::TextAntialiasing);
-        drawText(&painter, date);
-        return rendered;
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing, false);
+        painter->setRenderHint(QPainter::RenderHint::TextAntialiasing);
+        drawText(painter, date);
+        painter->restore();
+    }
+    
+    bool TemplatedText::isDateDependent() const
+    {
+        return true;
+    }
+    
+    PropertiesHash TemplatedText::hash(const QDate& date) const
+    {
+        PropertiesHash seed{ hashOf(properties.isVertical, properties.textAlign, properties.textColour,
+            properties.font, properties.pos) };
+        if (properties.texts.isEmpty())
+            return seed;
+
+        //Only the text of the selected month affects its output.
+        int idx{ (std::clamp(date.month(), 1, 12) - 1) % properties.texts.size() };
+        hashCombine(seed, properties.texts.at(idx));
+        return seed;
     }
     
+    std::unique_ptr<Element> TemplatedText::clone() const
+    {
+        auto copy = std::make_unique<TemplatedText>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void TemplatedText::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditTemplatedText>(&properties, parent);
         QString title{ dialog->windowTitle().arg(this->parent->text()) };
 
         dialog->setWindowTitle(title);
-        dialog->forwardConnect(std::bind(&TemplatedText::drawOutline, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawOutline();
+        });
         dialog->exec();
     }
     
@@ -124,17 +152,45 @@ namespace element
         drawOutline();
     }
 
+    void TemplatedText::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.textColour << properties.font << properties.pos << properties.isVertical
+            << properties.textAlign;
+
+        auto count = std::min(properties.texts.size(), 12);
+        *writer << static_cast<quint32>(count);
+        for (int idx{ 0 }; idx < count; idx++)
+            *writer << properties.texts[idx];
+    }
+
+    void TemplatedText::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        quint32 count{ 0 };
+        *reader >> properties.textColour >> properties.font >> properties.pos >> properties.isVertical
+            >> properties.textAlign >> count;
+
+        for (quint32 idx{ 0 }; idx < count && idx < 12; idx++)
+        {
+            QString text;
+            *reader >> text;
+            properties.texts.push_back(std::move(text));
+        }
+        drawOutline();
+    }
+
     void TemplatedText::drawOutline()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
+        if (parent == nullptr) return;
+
         QDate date{ QDate::currentDate() };
         date.setDate(date.year(), 1, 1);
-        drawText(&painter, date);
+        graphic.draw([this, date](QPainter* painter) { drawText(painter, date); });
         parent->renderOutline();
     }
 
-    void TemplatedText::drawText(QPainter* painter, const QDate& date)
+    void TemplatedText::drawText(QPainter* painter, const QDate& date) const
     {
         BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
         int idx{ std::clamp(date.month(), 1, 12) - 1 };
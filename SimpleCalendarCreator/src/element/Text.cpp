@@ -11,6 +11,9 @@
 #include <QRect>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
 #include "window/object_editor/EditText.hpp"
 
 namespace element
@@ -30,37 +33,56 @@ namespace element
     void Text::setParent(CustomListWidgetItem* parent)
     {
         this->parent = parent;
+        drawOutline();
     }
     
     void Text::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& Text::getRenderedGraphics()
+    const OutlineGraphic& Text::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap Text::render(const QDate& date)
+    void Text::paint(QPainter* painter, const QDate& date) const
+    {
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing, false);
+        painter->setRenderHint(QPainter::RenderHint::TextAntialiasing);
+        drawText(painter);
+        painter->restore();
+    }
+    
+    bool Text::isDateDependent() const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &rendered };
-        painter.setRenderHint(QPainter::RenderHint::TextAntialiasing);
-        drawText(&painter);
-        return rendered;
+        return false;
     }
     
+    PropertiesHash Text::hash(const QDate& date) const
+    {
+        return hashOf(properties.verticalText, properties.textAlignment, properties.textColour,
+            properties.font, properties.pos, properties.text);
+    }
+    
+    std::unique_ptr<Element> Text::clone() const
+    {
+        auto copy = std::make_unique<Text>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void Text::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditText>(&properties, parent);
         QString title = dialog->windowTitle().arg(this->parent->text());
         dialog->setWindowTitle(title);
-        dialog->forwardConnect(std::bind(&Text::drawOutline, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawOutline();
+        });
         dialog->exec();
     }
     
@@ -98,15 +120,31 @@ namespace element
         drawOutline();
     }
 
+    void Text::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.textColour << properties.font << properties.pos << properties.text
+            << properties.verticalText << properties.textAlignment;
+    }
+
+    void Text::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        *reader >> properties.textColour >> properties.font >> properties.pos >> properties.text
+            >> properties.verticalText >> properties.textAlignment;
+
+        drawOutline();
+    }
+
     void Text::drawOutline()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
-        drawText(&painter);
+        if (parent == nullptr) return;
+
+        graphic.draw([this](QPainter* painter) { drawText(painter); });
         parent->renderOutline();
     }
     
-    void Text::drawText(QPainter* painter)
+    void Text::drawText(QPainter* painter) const
     {
         BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
         QFontMetrics metrics{ properties.font };
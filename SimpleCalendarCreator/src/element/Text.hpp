@@ -62,11 +62,16 @@ namespace element
 
         void setParent(CustomListWidgetItem* parent) override;
         void setSize(const QSize& size) override;
-        const QPixmap& getRenderedGraphics() override;
-        QPixmap render(const QDate& date) override;
+        const OutlineGraphic& getRenderedGraphics() override;
+        void paint(QPainter* painter, const QDate& date) const override;
+        bool isDateDependent() const override;
+        PropertiesHash hash(const QDate& date) const override;
+        std::unique_ptr<Element> clone() const override;
         void edit(QWidget* parent = nullptr) override;
         void serialize(pugi::xml_node* node) override;
         void deserialize(const pugi::xml_node& node) override;
+        void serialize(project::DesignWriter* writer) override;
+        void deserialize(project::DesignReader* reader) override;
     private:
         /**
          * @internal
@@ -78,7 +83,7 @@ namespace element
          * General text renderer.
          * @param painter Painter to draw on, must not be nullptr.
          */
-        void drawText(QPainter* painter);
+        void drawText(QPainter* painter) const;
     private:
         /**
          * @internal
@@ -94,6 +99,6 @@ namespace element
          * @internal
          * Rendered graphic for previewing outline.
          */
-        QPixmap graphic;
+        OutlineGraphic graphic;
     };
 }
\ No newline at end of file
@@ -11,6 +11,10 @@
 #include <QPainter>
 
 #include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
+#include "render/TextLayoutCache.hpp"
 #include "window/object_editor/EditWeakTitle.hpp"
 
 namespace element
@@ -33,38 +37,65 @@ namespace element
     {
         BOOST_ASSERT_MSG(parent != nullptr, "parent must not be nullptr");
         this->parent = parent;
+        drawOutline();
     }
 
     void WeakTitle::setSize(const QSize& size)
     {
-        if (graphic.isNull())
-            graphic = QPixmap{ size };
-        else
-            graphic.scaled(size);
+        graphic.setCanvasSize(size);
     }
     
-    const QPixmap& WeakTitle::getRenderedGraphics()
+    const OutlineGraphic& WeakTitle::getRenderedGraphics()
     {
         return graphic;
     }
     
-    QPixmap WeakTitle::render(const QDate& date)
+    void WeakTitle::paint(QPainter* painter, const QDate& date) const
+    {
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        painter->setRenderHint(QPainter::RenderHint::Antialiasing, false);
+        painter->setRenderHint(QPainter::RenderHint::TextAntialiasing);
+        drawTitle(painter, date);
+        painter->restore();
+    }
+    
+    bool WeakTitle::isDateDependent() const
     {
-        QPixmap rendered{ graphic.size() };
-        rendered.fill(Qt::GlobalColor::transparent);
+        return true;
+    }
+    
+    PropertiesHash WeakTitle::hash(const QDate& date) const
+    {
+        PropertiesHash seed{ hashOf(properties.isVertical, properties.textAlignment,
+            properties.normalTextColour, properties.satTextColour, properties.sunTextColour, properties.font,
+            properties.fontRect) };
+        if (properties.lables.empty())
+            return seed;
 
-        QPainter painter{ &rendered };
-        painter.setRenderHint(QPainter::RenderHint::TextAntialiasing);
-        drawTitle(&painter, date);
-        return rendered;
+        //Only the label set of the selected month affects its output.
+        int idx{ (std::clamp(date.month(), 1, 12) - 1) % static_cast<int>(properties.lables.size()) };
+        for (const auto& itr : properties.lables[idx].second)
+            hashCombine(seed, itr);
+        return seed;
     }
     
+    std::unique_ptr<Element> WeakTitle::clone() const
+    {
+        auto copy = std::make_unique<WeakTitle>();
+        copy->properties = properties;
+        return copy;
+    }
+
     void WeakTitle::edit(QWidget* parent)
     {
         auto dialog = std::make_unique<EditWeakTitle>(&properties, parent);
         QString title{ dialog->windowTitle().arg(this->parent->text()) };
         dialog->setWindowTitle(title);
-        dialog->forwardConnect(std::bind(&WeakTitle::drawOutline, this));
+        dialog->forwardConnect([this]() {
+            this->parent->markChanged();
+            drawOutline();
+        });
         dialog->exec();
     }
     
@@ -136,18 +167,59 @@ namespace element
         properties.lables.shrink_to_fit();
         drawOutline();
     }
+
+    void WeakTitle::serialize(project::DesignWriter* writer)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        *writer << properties.normalTextColour << properties.satTextColour << properties.sunTextColour
+            << properties.font << properties.fontRect << properties.isVertical << properties.textAlignment;
+
+        *writer << static_cast<quint32>(properties.lables.size());
+        for (const auto& itr : properties.lables)
+        {
+            *writer << itr.first << static_cast<quint32>(itr.second.size());
+            for (const auto& itr2 : itr.second)
+                *writer << itr2;
+        }
+    }
+
+    void WeakTitle::deserialize(project::DesignReader* reader)
+    {
+        BOOST_ASSERT_MSG(reader != nullptr, "reader must not be nullptr");
+        quint32 groupCount{ 0 };
+        *reader >> properties.normalTextColour >> properties.satTextColour >> properties.sunTextColour
+            >> properties.font >> properties.fontRect >> properties.isVertical >> properties.textAlignment
+            >> groupCount;
+
+        for (quint32 idx{ 0 }; idx < groupCount; idx++)
+        {
+            QString name;
+            quint32 labelCount{ 0 };
+            *reader >> name >> labelCount;
+
+            std::vector<QString> labels;
+            for (quint32 idx2{ 0 }; idx2 < labelCount; idx2++)
+                *reader >> labels.emplace_back();
+
+            properties.lables.emplace_back(std::move(name), std::move(labels));
+        }
+        properties.lables.shrink_to_fit();
+        drawOutline();
+    }
     
     void WeakTitle::drawOutline()
     {
-        graphic.fill(Qt::GlobalColor::transparent);
-        QPainter painter{ &graphic };
+        if (parent == nullptr) return;
+
         QDate date{ QDate::currentDate().year(), 1, 1 };
-        painter.fillRect(properties.fontRect, QColor{ WeakTitle::outline_background_colour });
-        drawTitle(&painter, date);
+        graphic.draw([this, date](QPainter* painter) {
+            painter->fillRect(properties.fontRect, QColor{ WeakTitle::outline_background_colour });
+            drawTitle(painter, date);
+        });
         parent->renderOutline();
     }
 
-    void WeakTitle::drawTitle(QPainter* painter, const QDate& date)
+    void WeakTitle::drawTitle(QPainter* painter, const QDate& date) const
     {
         if (properties.lables.size() <= 0) return;
         painter->setFont(properties.font);
@@ -182,7 +254,7 @@ namespace element
             }
 
             painter->setPen(pen);
-            painter->drawText(labelRect, flags, itr);
+            render::TextLayoutCache::drawText(painter, labelRect, flags, itr);
             labelRect = QRect{
                 labelRect.x() + labelRect.width(),
                 labelRect.y(),
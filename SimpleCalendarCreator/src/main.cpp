@@ -3,12 +3,31 @@
 * License, v. 2.0.If a copy of the MPL was not distributed with this
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
+#include <QtGui/QGuiApplication>
 #include <QtWidgets/QApplication>
 
+#include "project/ProjectConverter.hpp"
+#include "render/BatchRenderer.hpp"
 #include "window/SimpleCalendarCreator.hpp"
 
 int main(int argc, char *argv[])
 {
+    if (render::BatchRenderer::isRequested(argc, argv))
+    {
+        //Batch mode never create widgets, so it can run on machines without display server.
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        QGuiApplication a{ argc, argv };
+        return render::BatchRenderer{}.exec(a.arguments());
+    }
+    if (project::ProjectConverter::isRequested(argc, argv))
+    {
+        if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        QGuiApplication a{ argc, argv };
+        return project::ProjectConverter{}.exec(a.arguments());
+    }
+
     QApplication a{ argc, argv };
     a.setAttribute(Qt::AA_EnableHighDpiScaling, true);
 
@@ -0,0 +1,111 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/DesignReader.hpp"
+
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+
+#include "project/DesignWriter.hpp"
+
+namespace project
+{
+    DesignReader::DesignReader(const char* data, std::size_t size):
+        data{ QByteArray::fromRawData(data, static_cast<int>(size)) }
+    {
+        BOOST_ASSERT_MSG(data != nullptr, "data must not be nullptr");
+        stream.setVersion(DesignWriter::stream_version);
+
+        quint32 magic{ 0 };
+        quint16 version{ 0 };
+        stream >> magic >> version;
+        if (stream.status() != QDataStream::Ok || magic != DesignWriter::magic)
+            throw std::runtime_error{ "Invalid binary design." };
+        if (version > DesignWriter::format_version)
+            throw std::runtime_error{ "Unable to open file, it's designed for newer program" };
+
+        qint32 width{ 0 };
+        qint32 height{ 0 };
+        quint32 stringCount{ 0 };
+        stream >> selectedYear >> width >> height >> stringCount;
+        checkStatus();
+        this->size = QSize{ width, height };
+
+        // Every string takes at least its length prefix, reject counts that can't fit before allocating.
+        if (stringCount > static_cast<quint32>(this->data.size() / sizeof(quint32)))
+            throw std::runtime_error{ "Corrupted binary design." };
+        strings.resize(stringCount);
+        for (auto& itr : strings)
+            stream >> itr;
+        stream >> objectCount;
+        checkStatus();
+        objectsBegin = stream.device()->pos();
+        remainingObjects = objectCount;
+    }
+
+    int DesignReader::getSelectedYear() const noexcept
+    {
+        return selectedYear;
+    }
+
+    QSize DesignReader::getSize() const noexcept
+    {
+        return size;
+    }
+
+    quint32 DesignReader::getObjectCount() const noexcept
+    {
+        return objectCount;
+    }
+
+    bool DesignReader::nextObject(QString* type, QString* name)
+    {
+        BOOST_ASSERT_MSG(type != nullptr, "type must not be nullptr");
+        BOOST_ASSERT_MSG(name != nullptr, "name must not be nullptr");
+
+        auto device = stream.device();
+        if (objectEnd >= 0)
+        {
+            if (device->pos() > objectEnd)
+                throw std::runtime_error{ "Corrupted binary design." };
+            device->seek(objectEnd);
+        }
+        if (remainingObjects == 0)
+            return false;
+        remainingObjects--;
+
+        quint32 length{ 0 };
+        objectEnd = -1;
+        *this >> *type >> *name >> length;
+        objectEnd = device->pos() + length;
+        if (objectEnd > device->size())
+            throw std::runtime_error{ "Corrupted binary design." };
+        return true;
+    }
+
+    void DesignReader::rewind()
+    {
+        stream.device()->seek(objectsBegin);
+        remainingObjects = objectCount;
+        objectEnd = -1;
+    }
+
+    DesignReader& DesignReader::operator>>(QString& value)
+    {
+        quint32 id{ 0 };
+        *this >> id;
+        if (id >= strings.size())
+            throw std::runtime_error{ "Corrupted binary design." };
+        value = strings[id];
+        return *this;
+    }
+
+    void DesignReader::checkStatus() const
+    {
+        if (stream.status() != QDataStream::Ok || (objectEnd >= 0 && stream.device()->pos() > objectEnd))
+            throw std::runtime_error{ "Corrupted binary design." };
+    }
+}
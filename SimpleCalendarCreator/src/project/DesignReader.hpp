@@ -0,0 +1,134 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include <qbytearray.h>
+#include <qdatastream.h>
+#include <qsize.h>
+#include <qstring.h>
+
+namespace project
+{
+    /**
+     * @brief Reader of the compact binary encoding of a calendar design, see project::DesignWriter for the
+     * layout.
+     *
+     * The reader does not copy the encoded design, the buffer must outlive the reader.
+     */
+    class DesignReader
+    {
+    public:
+        /**
+         * Read the header and string table of a binary design.
+         * @param data Encoded design.
+         * @param size Size of @p data in bytes.
+         * @throw std::runtime_error if @p data is not a binary design or is encoded by newer program.
+         */
+        DesignReader(const char* data, std::size_t size);
+        DesignReader(const DesignReader&) = delete;
+        DesignReader& operator=(const DesignReader&) = delete;
+
+        /**
+         * Get the targeted year of the design.
+         */
+        int getSelectedYear() const noexcept;
+        /**
+         * Get the size of the design.
+         */
+        QSize getSize() const noexcept;
+        /**
+         * Get the amount of calendar objects in the design.
+         */
+        quint32 getObjectCount() const noexcept;
+
+        /**
+         * Move to the record of next calendar object. The remaining payload of previous object is skipped.
+         * @param type Receive class name of the calendar object, must not be nullptr.
+         * @param name Receive name of the calendar object, must not be nullptr.
+         * @return false if there is no more object.
+         * @throw std::runtime_error if the design is corrupted.
+         */
+        bool nextObject(QString* type, QString* name);
+        /**
+         * Move back before the record of first calendar object, so the objects can be read again.
+         */
+        void rewind();
+
+        /**
+         * Read a typed value from the payload of current object.
+         * @throw std::runtime_error if the value is beyond the payload.
+         */
+        template <typename T>
+        DesignReader& operator>>(T& value)
+        {
+            stream >> value;
+            checkStatus();
+            return *this;
+        }
+        /**
+         * Read a string from the payload of current object.
+         * @throw std::runtime_error if the value is beyond the payload or not in the string table.
+         */
+        DesignReader& operator>>(QString& value);
+
+    private:
+        /**
+         * @internal
+         * Check if the last read is valid.
+         * @throw std::runtime_error if the design is corrupted.
+         */
+        void checkStatus() const;
+
+    private:
+        /**
+         * @internal
+         * Encoded design, refer to the caller's buffer without copy.
+         */
+        QByteArray data;
+        /**
+         * @internal
+         * Stream that read from data.
+         */
+        QDataStream stream{ data };
+        /**
+         * @internal
+         * Strings of the string table, in order of index.
+         */
+        std::vector<QString> strings;
+        /**
+         * @internal
+         * Target year of the design.
+         */
+        qint32 selectedYear{ 0 };
+        /**
+         * @internal
+         * Size of the design.
+         */
+        QSize size;
+        /**
+         * @internal
+         * Number of calendar objects in the design.
+         */
+        quint32 objectCount{ 0 };
+        /**
+         * @internal
+         * Position of the record of first calendar object.
+         */
+        qint64 objectsBegin{ 0 };
+        /**
+         * @internal
+         * Number of objects not read yet.
+         */
+        quint32 remainingObjects{ 0 };
+        /**
+         * @internal
+         * Position of the end of current object, -1 if no object is read yet.
+         */
+        qint64 objectEnd{ -1 };
+    };
+}
@@ -0,0 +1,89 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/DesignWriter.hpp"
+
+#include <boost/assert.hpp>
+
+#include "window/SimpleCalendarCreator.hpp"
+
+namespace project
+{
+    DesignWriter::DesignWriter(const CalendarProperties& properties):
+        selectedYear{ properties.selectedYear },
+        width{ properties.szCalendar.width() },
+        height{ properties.szCalendar.height() }
+    {
+        stream.setVersion(DesignWriter::stream_version);
+    }
+
+    void DesignWriter::beginObject(const QString& type, const QString& name)
+    {
+        BOOST_ASSERT_MSG(lengthPos < 0, "previous object is not finished");
+        stream << intern(type) << intern(name);
+        lengthPos = stream.device()->pos();
+        stream << quint32{ 0 };
+    }
+
+    void DesignWriter::endObject()
+    {
+        BOOST_ASSERT_MSG(lengthPos >= 0, "no object is started");
+        auto device = stream.device();
+        qint64 endPos{ device->pos() };
+        device->seek(lengthPos);
+        stream << static_cast<quint32>(endPos - lengthPos - sizeof(quint32));
+        device->seek(endPos);
+        lengthPos = -1;
+        objectCount++;
+    }
+
+    void DesignWriter::writeTo(ZipBufferWriter* output) const
+    {
+        BOOST_ASSERT_MSG(output != nullptr, "output must not be nullptr");
+        BOOST_ASSERT_MSG(lengthPos < 0, "last object is not finished");
+
+        QByteArray header{ makeHeader() };
+        output->write(header.constData(), static_cast<std::size_t>(header.size()));
+        output->write(objects.constData(), static_cast<std::size_t>(objects.size()));
+    }
+
+    QByteArray DesignWriter::toByteArray() const
+    {
+        BOOST_ASSERT_MSG(lengthPos < 0, "last object is not finished");
+        return makeHeader() + objects;
+    }
+
+    DesignWriter& DesignWriter::operator<<(const QString& value)
+    {
+        stream << intern(value);
+        return *this;
+    }
+
+    QByteArray DesignWriter::makeHeader() const
+    {
+        QByteArray header;
+        QDataStream headerStream{ &header, QIODevice::WriteOnly };
+        headerStream.setVersion(DesignWriter::stream_version);
+        headerStream << DesignWriter::magic << DesignWriter::format_version << selectedYear << width
+            << height;
+        headerStream << static_cast<quint32>(strings.size());
+        for (const auto& itr : strings)
+            headerStream << itr;
+        headerStream << objectCount;
+        return header;
+    }
+
+    quint32 DesignWriter::intern(const QString& value)
+    {
+        auto itr = stringIds.find(value);
+        if (itr != stringIds.end())
+            return *itr;
+
+        auto id = static_cast<quint32>(strings.size());
+        strings.push_back(value);
+        stringIds.insert(value, id);
+        return id;
+    }
+}
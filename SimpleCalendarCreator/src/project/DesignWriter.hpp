@@ -0,0 +1,143 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <vector>
+
+#include <qbytearray.h>
+#include <qdatastream.h>
+#include <qhash.h>
+#include <qstring.h>
+
+#include "project/ZipBufferWriter.hpp"
+
+struct CalendarProperties;
+
+namespace project
+{
+    /**
+     * @brief Writer of the compact binary encoding of a calendar design (design.bin).
+     *
+     * Layout, all values are written by QDataStream in big endian:
+     * - Header: magic, format version, target year, width and height of the design.
+     * - String table: number of strings followed by each length-prefixed string.
+     * - Objects: number of objects followed by each object record. A record holds the type and name as
+     *   indexes of the string table and the length of the payload written by element::Element::serialize(),
+     *   so readers can skip objects of unknown type.
+     *
+     * Strings written by elements are interned in the string table, other values such as colours, fonts and
+     * rectangles are written as typed values of QDataStream.
+     */
+    class DesignWriter
+    {
+    public:
+        /** Magic number at the start of a binary design, "SCCD". */
+        static constexpr quint32 magic{ 0x53434344 };
+        /** Version of the binary encoding, increased when the layout change. */
+        static constexpr quint16 format_version{ 1 };
+        /** Version of QDataStream used to encode the typed values. */
+        static constexpr int stream_version{ QDataStream::Qt_5_13 };
+    public:
+        /**
+         * Create writer of a calendar design.
+         * @param properties Properties of the calendar design.
+         */
+        explicit DesignWriter(const CalendarProperties& properties);
+        DesignWriter(const DesignWriter&) = delete;
+        DesignWriter& operator=(const DesignWriter&) = delete;
+
+        /**
+         * Start the record of a calendar object, must be followed by endObject().
+         * @param type Class name of the calendar object.
+         * @param name Name of the calendar object given by user.
+         */
+        void beginObject(const QString& type, const QString& name);
+        /**
+         * Finish the record started by beginObject().
+         */
+        void endObject();
+        /**
+         * Write the complete design to @p output.
+         */
+        void writeTo(ZipBufferWriter* output) const;
+        /**
+         * Get the complete design as a byte array.
+         */
+        QByteArray toByteArray() const;
+
+        /**
+         * Write a typed value to the payload of current object.
+         */
+        template <typename T>
+        DesignWriter& operator<<(const T& value)
+        {
+            stream << value;
+            return *this;
+        }
+        /**
+         * Write a string to the payload of current object as index of the string table.
+         */
+        DesignWriter& operator<<(const QString& value);
+
+    private:
+        /**
+         * @internal
+         * Encode the header and string table that precede the objects.
+         */
+        QByteArray makeHeader() const;
+        /**
+         * @internal
+         * Get index of @p value in the string table, add it to the table if not exists.
+         */
+        quint32 intern(const QString& value);
+
+    private:
+        /**
+         * @internal
+         * Target year of the design.
+         */
+        qint32 selectedYear{ 0 };
+        /**
+         * @internal
+         * Width of the design.
+         */
+        qint32 width{ 0 };
+        /**
+         * @internal
+         * Height of the design.
+         */
+        qint32 height{ 0 };
+        /**
+         * @internal
+         * Strings of the string table, in order of index.
+         */
+        std::vector<QString> strings;
+        /**
+         * @internal
+         * Map strings to their index in the string table.
+         */
+        QHash<QString, quint32> stringIds;
+        /**
+         * @internal
+         * Encoded object records.
+         */
+        QByteArray objects;
+        /**
+         * @internal
+         * Stream that write to objects.
+         */
+        QDataStream stream{ &objects, QIODevice::WriteOnly };
+        /**
+         * @internal
+         * Number of objects written.
+         */
+        quint32 objectCount{ 0 };
+        /**
+         * @internal
+         * Position of the payload length of current object, -1 if no object is started.
+         */
+        qint64 lengthPos{ -1 };
+    };
+}
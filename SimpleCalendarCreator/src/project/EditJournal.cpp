@@ -0,0 +1,470 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/EditJournal.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <unordered_set>
+
+#include <boost/assert.hpp>
+
+#include <qdatetime.h>
+#include <qdir.h>
+#include <qfileinfo.h>
+#include <qstandardpaths.h>
+#include <quuid.h>
+
+#include "element/CalendarObjectFactory.hpp"
+#include "element/CustomListWidgetItem.hpp"
+#include "project/DesignReader.hpp"
+#include "project/DesignWriter.hpp"
+
+#ifdef _DEBUG
+#include <qdebug.h>
+#endif // _DEBUG
+
+namespace project
+{
+    EditJournal::EditJournal():
+        untitledPath{ QString{ "%1/%2%3%4" }.arg(getUntitledDirectory()).arg(EditJournal::untitled_prefix)
+            .arg(QUuid::createUuid().toString(QUuid::StringFormat::WithoutBraces))
+            .arg(EditJournal::file_suffix) }
+    {
+    }
+
+    bool EditJournal::findRecoverable()
+    {
+        recoverPath.clear();
+        recoverLock = nullptr;
+        if (!started) return false;
+
+        //Journals set aside by an interrupted adoptRecoverable() come first, the journal written beside them
+        //may be cut short.
+        QStringList candidates;
+        if (projectPath.isEmpty())
+        {
+            //Latest first, the journal of this instance is never a candidate.
+            QDir directory{ getUntitledDirectory() };
+            QString pattern{ QString{ EditJournal::untitled_prefix } + "*" + EditJournal::file_suffix };
+            QString ownPath{ QFileInfo{ journalPath }.absoluteFilePath() };
+            for (const auto& suffix : { QString{ EditJournal::aside_suffix }, QString{} })
+            {
+                auto journals = directory.entryInfoList({ pattern + suffix }, QDir::Filter::Files,
+                    QDir::SortFlag::Time);
+                for (const auto& itr : journals)
+                {
+                    if (getWriterPath(itr.absoluteFilePath()) != ownPath)
+                        candidates.push_back(itr.absoluteFilePath());
+                }
+            }
+        }
+        else
+        {
+            candidates.push_back(journalPath + EditJournal::aside_suffix);
+            candidates.push_back(journalPath);
+        }
+
+        for (const auto& candidate : candidates)
+        {
+            //A journal set aside is guarded by the lock of the journal it's handed over to.
+            QString writerPath{ getWriterPath(candidate) };
+            std::unique_ptr<QLockFile> candidateLock{ nullptr };
+            if (writerPath != journalPath || lock == nullptr)
+            {
+                candidateLock = tryLock(writerPath);
+                if (candidateLock == nullptr) continue;  //Still written by a running instance.
+            }
+
+            bool recoverable{ false };
+            try
+            {
+                QFile input;
+                QDataStream stream;
+                recoverable = openJournal(candidate, projectPath, &input, &stream) && !stream.atEnd();
+            }
+            catch (const std::exception& e)
+            {
+#ifdef _DEBUG
+                qDebug() << e.what();
+#endif // _DEBUG
+            }
+            if (!recoverable) continue;
+
+            recoverPath = candidate;
+            if (writerPath == journalPath)
+            {
+                if (candidateLock != nullptr)
+                    lock = std::move(candidateLock);
+            }
+            else
+            {
+                recoverLock = std::move(candidateLock);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    int EditJournal::replay(const RecordReceiver& receiver) const
+    {
+        BOOST_ASSERT_MSG(receiver != nullptr, "receiver must not be nullptr");
+        BOOST_ASSERT_MSG(!recoverPath.isEmpty(), "no journal is found by findRecoverable()");
+
+        QFile input;
+        QDataStream stream;
+        if (!openJournal(recoverPath, projectPath, &input, &stream)) return 0;
+
+        CalendarObjectFactory factory;
+        int replayed{ 0 };
+        while (!stream.atEnd())
+        {
+            quint8 operation{ 0 };
+            qint32 row{ 0 };
+            QByteArray data;
+            stream >> operation >> row >> data;
+            if (stream.status() != QDataStream::Ok) break;
+
+            Record record;
+            record.operation = static_cast<Operation>(operation);
+            record.row = row;
+            switch (record.operation)
+            {
+            case Operation::properties:
+            {
+                DesignReader reader{ data.constData(), static_cast<std::size_t>(data.size()) };
+                record.properties = CalendarProperties{ reader.getSelectedYear(), reader.getSize() };
+                break;
+            }
+            case Operation::insert:
+            case Operation::update:
+            {
+                DesignReader reader{ data.constData(), static_cast<std::size_t>(data.size()) };
+                QString type;
+                if (!reader.nextObject(&type, &record.name))
+                    throw std::runtime_error{ "Corrupted edit journal." };
+                try
+                {
+                    record.object = factory.createObject(type);
+                }
+                catch (const std::out_of_range&)
+                {
+                    throw std::runtime_error{ "Corrupted edit journal." };
+                }
+                record.object->deserialize(&reader);
+                break;
+            }
+            case Operation::remove:
+                break;
+            default:
+                throw std::runtime_error{ "Corrupted edit journal." };
+            }
+
+            receiver(record);
+            replayed++;
+        }
+        return replayed;
+    }
+
+    void EditJournal::dropRecoverable() noexcept
+    {
+        if (recoverPath.isEmpty()) return;
+
+        //The journal a set aside journal is handed over to holds part of the same records.
+        QString writerPath{ getWriterPath(recoverPath) };
+        if (writerPath == journalPath)
+            file.close();
+        QFile::remove(recoverPath);
+        QFile::remove(writerPath);
+        recoverPath.clear();
+        recoverLock = nullptr;
+    }
+
+    void EditJournal::adoptRecoverable(const CalendarProperties& properties, const QListWidget& list) noexcept
+    {
+        if (recoverPath.isEmpty() || failed) return;
+
+        //The aside journal is guarded by the lock of this instance, take it before renaming.
+        if (lock == nullptr)
+            lock = tryLock(journalPath);
+        QString asidePath{ journalPath + EditJournal::aside_suffix };
+        QString writerPath{ getWriterPath(recoverPath) };
+        if (recoverPath != asidePath)
+        {
+            if (recoverPath == journalPath)
+                file.close();
+            QFile::remove(asidePath);
+            if (lock == nullptr || !QFile::rename(recoverPath, asidePath))
+            {
+                //Journaling may overwrite the only copy of the records, keep it for next run and stop.
+                failed = true;
+                recoverPath.clear();
+                recoverLock = nullptr;
+                return;
+            }
+        }
+
+        record(properties, list);
+        if (!failed)
+        {
+            //Nothing is written if the recovered design equals the saved design, drop any journal cut short.
+            if (!file.isOpen())
+                removeJournal();
+            QFile::remove(asidePath);
+            if (writerPath != journalPath)
+                QFile::remove(writerPath);
+        }
+        recoverPath.clear();
+        recoverLock = nullptr;
+    }
+
+    QString EditJournal::keepRecoverable() noexcept
+    {
+        if (recoverPath.isEmpty()) return QString{};
+
+        QString writerPath{ getWriterPath(recoverPath) };
+        if (writerPath == journalPath)
+            file.close();
+        if (writerPath != recoverPath)
+            QFile::remove(writerPath);
+        QString badPath{ recoverPath + EditJournal::bad_suffix };
+        QFile::remove(badPath);
+        if (!QFile::rename(recoverPath, badPath))
+        {
+            QFile::remove(recoverPath);
+            badPath.clear();
+        }
+        recoverPath.clear();
+        recoverLock = nullptr;
+        return badPath;
+    }
+
+    const QString& EditJournal::getProjectPath() const noexcept
+    {
+        return projectPath;
+    }
+
+    void EditJournal::start(const QString& projectPath, const CalendarProperties& properties,
+        const QListWidget& list)
+    {
+        switchProject(projectPath);
+        this->properties = properties;
+        objects = track(list);
+    }
+
+    void EditJournal::record(const CalendarProperties& properties, const QListWidget& list) noexcept
+    {
+        if (!started || failed) return;
+
+        try
+        {
+            if (properties != this->properties)
+            {
+                append(Operation::properties, -1, DesignWriter{ properties }.toByteArray());
+                this->properties = properties;
+            }
+
+            std::vector<CustomListWidgetItem*> items;
+            items.reserve(list.count());
+            for (int idx{ 0 }; idx < list.count(); idx++)
+            {
+                auto item = static_cast<CustomListWidgetItem*>(list.item(idx));
+                if (item->getElement() != nullptr)
+                    items.push_back(item);
+            }
+            std::unordered_set<const CustomListWidgetItem*> listed{ items.begin(), items.end() };
+
+            //Remove from the back so the rows of the objects not yet visited stay valid.
+            for (auto idx = static_cast<int>(objects.size()) - 1; idx >= 0; idx--)
+            {
+                if (listed.count(objects[idx].item) > 0) continue;
+                append(Operation::remove, idx, QByteArray{});
+                objects.erase(objects.begin() + idx);
+            }
+
+            //Match the remaining objects row by row, an object found at another row is moved by removing and
+            //inserting it again. Only objects changed since they were journaled are encoded, an address
+            //reused by a new item has a newer stamp so it turns into an update.
+            for (int row{ 0 }; row < static_cast<int>(items.size()); row++)
+            {
+                CustomListWidgetItem* item{ items[row] };
+                if (row < static_cast<int>(objects.size()) && objects[row].item == item)
+                {
+                    if (objects[row].changeStamp == item->getChangeStamp()) continue;
+                    append(Operation::update, row, encodeObject(item->text(), *item->getElement()));
+                    objects[row].changeStamp = item->getChangeStamp();
+                    continue;
+                }
+
+                auto first = objects.begin() + std::min(static_cast<std::size_t>(row), objects.size());
+                auto moved = std::find_if(first, objects.end(),
+                    [item](const TrackedObject& itr) { return itr.item == item; });
+                if (moved != objects.end())
+                {
+                    append(Operation::remove, static_cast<int>(std::distance(objects.begin(), moved)),
+                        QByteArray{});
+                    objects.erase(moved);
+                }
+                append(Operation::insert, row, encodeObject(item->text(), *item->getElement()));
+                objects.insert(objects.begin() + row, TrackedObject{ item, item->getChangeStamp() });
+            }
+        }
+        catch (const std::exception& e)
+        {
+#ifdef _DEBUG
+            qDebug() << e.what();
+#endif // _DEBUG
+            //A partially written journal can't be trusted for recovery, a journal set aside is still whole.
+            failed = true;
+            removeJournal();
+        }
+    }
+
+    void EditJournal::checkpoint(const CalendarProperties& properties, const QListWidget& list)
+    {
+        //Taken from the design rather than the journaled state, which is stale once journaling failed.
+        checkpointProperties = properties;
+        checkpointObjects = track(list);
+    }
+
+    void EditJournal::restart(const QString& projectPath)
+    {
+        switchProject(projectPath);
+        properties = checkpointProperties;
+        objects = std::move(checkpointObjects);
+        checkpointObjects.clear();
+    }
+
+    void EditJournal::discard() noexcept
+    {
+        if (!started || lock == nullptr) return;
+
+        removeJournal();
+        QFile::remove(journalPath + EditJournal::aside_suffix);
+    }
+
+    void EditJournal::removeJournal() noexcept
+    {
+        if (!started || lock == nullptr) return;
+
+        file.close();
+        QFile::remove(journalPath);
+    }
+
+    std::vector<EditJournal::TrackedObject> EditJournal::track(const QListWidget& list)
+    {
+        std::vector<TrackedObject> tracked;
+        tracked.reserve(list.count());
+        for (int idx{ 0 }; idx < list.count(); idx++)
+        {
+            auto item = static_cast<const CustomListWidgetItem*>(list.item(idx));
+            if (item->getElement() != nullptr)
+                tracked.push_back(TrackedObject{ item, item->getChangeStamp() });
+        }
+        return tracked;
+    }
+
+    void EditJournal::switchProject(const QString& projectPath)
+    {
+        discard();
+        QString path{ projectPath.isEmpty() ? untitledPath : projectPath + EditJournal::file_suffix };
+        //Release the lock of the previous journal, the lock of the same journal is kept.
+        if (path != journalPath)
+            lock = nullptr;
+
+        this->projectPath = projectPath;
+        journalPath = path;
+        started = true;
+        failed = false;
+        baseTime = getBaseTime(projectPath);
+    }
+
+    QByteArray EditJournal::encodeObject(const QString& name, element::Element& object)
+    {
+        //The calendar properties are recorded on their own, placeholder values are written for them.
+        DesignWriter writer{ CalendarProperties{ 0, QSize{} } };
+        writer.beginObject(QString::fromStdString(element::Element::getTypeName(object)), name);
+        object.serialize(&writer);
+        writer.endObject();
+        return writer.toByteArray();
+    }
+
+    qint64 EditJournal::getBaseTime(const QString& projectPath)
+    {
+        if (projectPath.isEmpty()) return 0;
+        return QFileInfo{ projectPath }.lastModified().toMSecsSinceEpoch();
+    }
+
+    QString EditJournal::getUntitledDirectory()
+    {
+        return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    }
+
+    QString EditJournal::getWriterPath(const QString& path)
+    {
+        if (!path.endsWith(EditJournal::aside_suffix)) return path;
+        return path.left(path.size() - static_cast<int>(std::strlen(EditJournal::aside_suffix)));
+    }
+
+    std::unique_ptr<QLockFile> EditJournal::tryLock(const QString& journalPath)
+    {
+        auto lock = std::make_unique<QLockFile>(journalPath + EditJournal::lock_suffix);
+        //Locks are held as long as the journal is written, they are only stale when the owner is not running.
+        lock->setStaleLockTime(0);
+        if (!lock->tryLock(0)) return nullptr;
+        return lock;
+    }
+
+    bool EditJournal::openJournal(const QString& journalPath, const QString& projectPath, QFile* file,
+        QDataStream* stream)
+    {
+        BOOST_ASSERT_MSG(file != nullptr, "file must not be nullptr");
+        BOOST_ASSERT_MSG(stream != nullptr, "stream must not be nullptr");
+
+        file->setFileName(journalPath);
+        if (!file->open(QIODevice::ReadOnly)) return false;
+        stream->setDevice(file);
+        stream->setVersion(DesignWriter::stream_version);
+
+        quint32 magic{ 0 };
+        quint16 version{ 0 };
+        qint64 base{ 0 };
+        *stream >> magic >> version >> base;
+        if (stream->status() != QDataStream::Ok || magic != EditJournal::magic)
+            throw std::runtime_error{ "Invalid edit journal." };
+        if (version > EditJournal::format_version)
+            throw std::runtime_error{ "Unable to recover changes, the journal is written by newer program" };
+        return base == getBaseTime(projectPath);
+    }
+
+    void EditJournal::append(Operation operation, int row, const QByteArray& data)
+    {
+        QByteArray buffer;
+        QDataStream stream{ &buffer, QIODevice::WriteOnly };
+        stream.setVersion(DesignWriter::stream_version);
+        if (!file.isOpen())
+        {
+            QDir{}.mkpath(QFileInfo{ journalPath }.absolutePath());
+            if (lock == nullptr)
+                lock = tryLock(journalPath);
+            if (lock == nullptr)
+                throw std::runtime_error{ "Edit journal is written by another instance." };
+            file.setFileName(journalPath);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+                throw std::runtime_error{ "Unable to create edit journal: " +
+                    file.errorString().toStdString() };
+            }
+            stream << EditJournal::magic << EditJournal::format_version << baseTime;
+        }
+        stream << static_cast<quint8>(operation) << static_cast<qint32>(row) << data;
+
+        //Flushed per record, so the journal survives the program crashing right after the edit.
+        if (file.write(buffer) != buffer.size() || !file.flush())
+            throw std::runtime_error{ "Unable to write edit journal: " + file.errorString().toStdString() };
+    }
+}
@@ -0,0 +1,319 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <qbytearray.h>
+#include <qdatastream.h>
+#include <qfile.h>
+#include <qlistwidget.h>
+#include <qlockfile.h>
+#include <qstring.h>
+
+#include "element/Element.hpp"
+#include "window/SimpleCalendarCreator.hpp"
+
+class CustomListWidgetItem;
+
+namespace project
+{
+    /**
+     * @brief Append-only journal of the edits made since the design is last saved, used to recover unsaved
+     * work when the program did not exit properly.
+     *
+     * Commands only hold observers to the properties they modify, so the journal records the changes a
+     * command made to the design instead of the command itself. After each UndoHistory::push() or pop(),
+     * record() compares the object list with the one already journaled and appends a small record for each
+     * calendar object inserted, removed or modified and for changed calendar properties. Only the objects
+     * inserted or changed since the last record, told by CustomListWidgetItem::getChangeStamp(), are encoded.
+     * Replaying the records onto the last saved design restores the design as of the last edit.
+     *
+     * The journal of a project is kept next to it as "<project>.journal", the journal of a design that is not
+     * saved yet is kept in the application data directory under a name unique to the instance. The file is
+     * created by the first record and removed by discard() once the edits are saved or dropped. A lock file
+     * is held beside the journal while it's written, so a journal of a running instance is never recovered,
+     * overwritten or removed by another instance.
+     */
+    class EditJournal
+    {
+    public:
+        /** Suffix appended to the project path to get the journal path. */
+        static constexpr char file_suffix[]{ ".journal" };
+        /** Suffix appended to the journal path to get its lock file. */
+        static constexpr char lock_suffix[]{ ".lock" };
+        /** Suffix appended to the journal path while recovered records are journaled again. */
+        static constexpr char aside_suffix[]{ ".old" };
+        /** Suffix appended to the journal path when its records can't be replayed. */
+        static constexpr char bad_suffix[]{ ".bad" };
+        /** Prefix of the journals of designs that are not saved yet. */
+        static constexpr char untitled_prefix[]{ "untitled-" };
+        /** Identifier of the journal, "SCJL". */
+        static constexpr quint32 magic{ 0x53434a4c };
+        /** Version of the journal format. */
+        static constexpr quint16 format_version{ 1 };
+
+        /**
+         * Change described by a record.
+         */
+        enum class Operation : quint8
+        {
+            properties,  /**< Calendar properties changed. */
+            insert,  /**< Calendar object inserted. */
+            update,  /**< Calendar object or its name modified. */
+            remove  /**< Calendar object removed. */
+        };
+
+        /**
+         * Record read from the journal.
+         */
+        struct Record
+        {
+            /** Change described by the record. */
+            Operation operation{ Operation::properties };
+            /** Row of the calendar object in the object list, unused by Operation::properties. */
+            int row{ -1 };
+            /** New calendar properties, only used by Operation::properties. */
+            CalendarProperties properties{ 1997, SimpleCalendarCreator::default_calender_size };
+            /** Name of the calendar object, used by Operation::insert and Operation::update. */
+            QString name;
+            /** Calendar object, used by Operation::insert and Operation::update. */
+            std::unique_ptr<element::Element> object{ nullptr };
+        };
+        /**
+         * Receive the records in order they are appended, the object of the record may be taken.
+         */
+        using RecordReceiver = std::function<void(Record& record)>;
+    public:
+        /**
+         * Create new journal, nothing is journaled until start() is called.
+         */
+        EditJournal();
+        EditJournal(const EditJournal&) = delete;
+        EditJournal& operator=(const EditJournal&) = delete;
+
+        /**
+         * Find a journal left by an instance that is no longer running, with records to replay onto the
+         * design passed to start(). For a project it's the journal of the project, for a design that is not
+         * saved yet it's the latest journal of an unsaved design. The journal is locked until it's dropped.
+         * @return true if found, see replay().
+         */
+        bool findRecoverable();
+        /**
+         * Read the journal found by findRecoverable() and pass each record to @p receiver. A record cut short
+         * by an unexpected exit ends the journal.
+         * @param receiver Receiver of the records.
+         * @return Amount of records replayed.
+         * @throw std::runtime_error if the journal is corrupted.
+         */
+        int replay(const RecordReceiver& receiver) const;
+        /**
+         * Remove the journal found by findRecoverable() when it's refused.
+         */
+        void dropRecoverable() noexcept;
+        /**
+         * Journal the design the journal found by findRecoverable() is replayed onto, then remove that
+         * journal. It's set aside until the records are written again, so a crash in between leaves it to be
+         * found by the next findRecoverable(). It's kept aside if the records can't be written.
+         * @param properties Current properties of the design.
+         * @param list Current calendar objects of the design.
+         */
+        void adoptRecoverable(const CalendarProperties& properties, const QListWidget& list) noexcept;
+        /**
+         * Set aside the journal found by findRecoverable() when it can't be replayed, it's renamed with
+         * bad_suffix so it's kept for inspection but never offered again.
+         * @return Path of the journal set aside, empty if it can't be renamed and is removed instead.
+         */
+        QString keepRecoverable() noexcept;
+
+        /**
+         * Get the path of the project being journaled.
+         */
+        const QString& getProjectPath() const noexcept;
+
+        /**
+         * Start journaling a design loaded from a project, the journal of the previous project is discarded.
+         * @param projectPath Path of the project, empty for a design that is not saved yet.
+         * @param properties Properties of the saved design.
+         * @param list Calendar objects of the saved design.
+         */
+        void start(const QString& projectPath, const CalendarProperties& properties, const QListWidget& list);
+        /**
+         * Append the changes made to the design since the last record. Journaling stops if the journal can't
+         * be written, editing goes on without it.
+         * @param properties Current properties of the design.
+         * @param list Current calendar objects of the design.
+         */
+        void record(const CalendarProperties& properties, const QListWidget& list) noexcept;
+        /**
+         * Remember the design when a snapshot of it is taken for saving, see restart().
+         * @param properties Properties of the snapshot.
+         * @param list Calendar objects of the snapshot.
+         */
+        void checkpoint(const CalendarProperties& properties, const QListWidget& list);
+        /**
+         * Restart the journal from the state remembered by checkpoint() once the snapshot is saved. Call
+         * record() afterward to journal the edits made while saving.
+         * @param projectPath Path where the snapshot is saved.
+         */
+        void restart(const QString& projectPath);
+        /**
+         * Remove the journal file and the journal set aside by adoptRecoverable() if they're written by this
+         * instance. The journaled state is kept, so only call it when the design equals the saved design or
+         * is dropped.
+         */
+        void discard() noexcept;
+
+    private:
+        /**
+         * @internal
+         * Calendar object as it was last journaled.
+         */
+        struct TrackedObject
+        {
+            /** Observer to the item holding the object, only used to match the object between records. */
+            const CustomListWidgetItem* item{ nullptr };
+            /** Change stamp of the item when it was journaled. */
+            std::uint64_t changeStamp{ 0 };
+        };
+
+    private:
+        /**
+         * @internal
+         * Get the calendar objects of @p list as they are now.
+         */
+        static std::vector<TrackedObject> track(const QListWidget& list);
+        /**
+         * @internal
+         * Encode a calendar object and its name as a binary design with single object.
+         */
+        static QByteArray encodeObject(const QString& name, element::Element& object);
+        /**
+         * @internal
+         * Get the last modified time of the saved project, which identify the design the journal applied to.
+         */
+        static qint64 getBaseTime(const QString& projectPath);
+        /**
+         * @internal
+         * Get the directory of the journals of designs that are not saved yet.
+         */
+        static QString getUntitledDirectory();
+        /**
+         * @internal
+         * Get the path of the journal written by the instance that set aside @p path, @p path itself if it's
+         * not set aside.
+         */
+        static QString getWriterPath(const QString& path);
+        /**
+         * @internal
+         * Lock a journal for this instance.
+         * @return The lock, nullptr if the journal is locked by a running instance.
+         */
+        static std::unique_ptr<QLockFile> tryLock(const QString& journalPath);
+        /**
+         * @internal
+         * Open a journal for reading and check its header.
+         * @param journalPath Path of the journal.
+         * @param projectPath Path of the project the journal applies to.
+         * @return true if the journal exists and applies to the saved project.
+         * @throw std::runtime_error if the journal is not valid.
+         */
+        static bool openJournal(const QString& journalPath, const QString& projectPath, QFile* file,
+            QDataStream* stream);
+        /**
+         * @internal
+         * Discard the current journal and switch to the journal of @p projectPath, shared by start() and
+         * restart().
+         */
+        void switchProject(const QString& projectPath);
+        /**
+         * @internal
+         * Close and remove the journal being written if it's written by this instance, a journal set aside is
+         * kept.
+         */
+        void removeJournal() noexcept;
+        /**
+         * @internal
+         * Append a record and flush it to the journal, the journal is created if not exists.
+         * @throw std::runtime_error if the journal can't be written.
+         */
+        void append(Operation operation, int row, const QByteArray& data);
+
+    private:
+        /**
+         * @internal
+         * Path of the project being journaled.
+         */
+        QString projectPath;
+        /**
+         * @internal
+         * Path of the journal being written.
+         */
+        QString journalPath;
+        /**
+         * @internal
+         * Path of the journal of this instance while the design is not saved yet.
+         */
+        QString untitledPath;
+        /**
+         * @internal
+         * Lock of the journal being written, acquired with the first record.
+         */
+        std::unique_ptr<QLockFile> lock{ nullptr };
+        /**
+         * @internal
+         * Path of the journal found by findRecoverable().
+         */
+        QString recoverPath;
+        /**
+         * @internal
+         * Lock of the journal found by findRecoverable(), nullptr if it's the journal being written.
+         */
+        std::unique_ptr<QLockFile> recoverLock{ nullptr };
+        /**
+         * @internal
+         * Determine if start() is called, discard() never touch a journal that is not started.
+         */
+        bool started{ false };
+        /**
+         * @internal
+         * Determine if the journal can't be written, no more record is appended until restarted.
+         */
+        bool failed{ false };
+        /**
+         * @internal
+         * Last modified time of the saved project.
+         */
+        qint64 baseTime{ 0 };
+        /**
+         * @internal
+         * Journal file, open after the first record.
+         */
+        QFile file;
+        /**
+         * @internal
+         * Calendar properties as they were last journaled.
+         */
+        CalendarProperties properties{ 1997, SimpleCalendarCreator::default_calender_size };
+        /**
+         * @internal
+         * Calendar objects as they were last journaled, in z-order.
+         */
+        std::vector<TrackedObject> objects;
+        /**
+         * @internal
+         * Calendar properties remembered by checkpoint().
+         */
+        CalendarProperties checkpointProperties{ 1997, SimpleCalendarCreator::default_calender_size };
+        /**
+         * @internal
+         * Calendar objects remembered by checkpoint().
+         */
+        std::vector<TrackedObject> checkpointObjects;
+    };
+}
@@ -0,0 +1,106 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/ProjectConverter.hpp"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <qcommandlineparser.h>
+#include <qelapsedtimer.h>
+
+#include "project/ProjectFile.hpp"
+
+namespace project
+{
+    bool ProjectConverter::isRequested(int argc, char* argv[]) noexcept
+    {
+        for (int idx{ 1 }; idx < argc; idx++)
+        {
+            if (std::strcmp(argv[idx], "--convert") == 0)
+                return true;
+        }
+        return false;
+    }
+
+    int ProjectConverter::exec(const QStringList& arguments)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Convert the design encoding of a calendar design.");
+        parser.addHelpOption();
+        QCommandLineOption optConvert{ "convert", "Calendar design to convert.", "project" };
+        QCommandLineOption optTo{ "to", "Encoding of the converted design: xml or binary (default).",
+            "encoding", "binary" };
+        QCommandLineOption optOut{ "out", "Path of the converted design, overwrite the project by default.",
+            "file" };
+        parser.addOptions({ optConvert, optTo, optOut });
+
+        auto usageError = [&parser](const QString& message) {
+            std::cerr << message.toStdString() << std::endl << parser.helpText().toStdString();
+            return ProjectConverter::exit_invalid_arguments;
+        };
+
+        if (!parser.parse(arguments))
+            return usageError(parser.errorText());
+        if (parser.isSet("help"))
+        {
+            std::cout << parser.helpText().toStdString();
+            return ProjectConverter::exit_success;
+        }
+        if (!parser.isSet(optConvert))
+            return usageError("--convert is required.");
+        QString to{ parser.value(optTo).toLower() };
+        if (to != "xml" && to != "binary")
+            return usageError(QString{ "Invalid encoding \"%1\"." }.arg(parser.value(optTo)));
+        auto encoding = to == "xml" ? ProjectFile::Encoding::xml : ProjectFile::Encoding::binary;
+
+        QString input{ parser.value(optConvert) };
+        QString output{ parser.isSet(optOut) ? parser.value(optOut) : input };
+
+        QElapsedTimer timer;
+        timer.start();
+
+        std::unique_ptr<ProjectFile> projectFile{ nullptr };
+        std::vector<std::unique_ptr<element::Element>> elements;
+        std::vector<ProjectFile::NamedObject> objects;
+        try
+        {
+            projectFile = std::make_unique<ProjectFile>(input);
+            projectFile->loadObjects([&elements, &objects](const QString& name,
+                std::unique_ptr<element::Element> object) {
+                elements.push_back(std::move(object));
+                objects.emplace_back(name, elements.back().get());
+                return elements.back().get();
+            });
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load \"" << input.toStdString() << "\": " << e.what() << std::endl;
+            return ProjectConverter::exit_load_failed;
+        }
+        qint64 loadTime{ timer.restart() };
+
+        ProjectFile::SaveStatistics statistics;
+        try
+        {
+            statistics = ProjectFile::save(output, projectFile->getProperties(), objects, encoding,
+                projectFile->getCreatedTime());
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to save \"" << output.toStdString() << "\": " << e.what() << std::endl;
+            return ProjectConverter::exit_save_failed;
+        }
+
+        std::cout << "load: " << loadTime << " ms" << std::endl
+            << "save: " << timer.elapsed() << " ms (serialize: " << statistics.serializeTime << " ms, stage: "
+            << statistics.stageTime << " ms, compress and write: " << statistics.writeTime << " ms)"
+            << std::endl
+            << "design: " << statistics.designSize << " bytes" << std::endl;
+        return ProjectConverter::exit_success;
+    }
+}
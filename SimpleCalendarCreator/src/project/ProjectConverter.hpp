@@ -0,0 +1,44 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <qstringlist.h>
+
+namespace project
+{
+    /**
+     * @brief Command line mode that convert the design encoding of a project file without creating any
+     * widget.
+     *
+     * Usage: SimpleCalendarCreator --convert <project.calendar> [--to xml|binary] [--out <file>]
+     *
+     * The design is loaded and saved by project::ProjectFile, the same code path used by the main window. It
+     * must run under a QGuiApplication, usually with the "offscreen" platform.
+     */
+    class ProjectConverter
+    {
+    public:
+        /** Exit code when the project is converted. */
+        static constexpr int exit_success{ 0 };
+        /** Exit code when the command line arguments are invalid. */
+        static constexpr int exit_invalid_arguments{ 1 };
+        /** Exit code when the project can't be loaded. */
+        static constexpr int exit_load_failed{ 2 };
+        /** Exit code when the converted project can't be saved. */
+        static constexpr int exit_save_failed{ 3 };
+    public:
+        /**
+         * Determine if the conversion is requested by the command line, usable before the application object
+         * is created.
+         */
+        static bool isRequested(int argc, char* argv[]) noexcept;
+        /**
+         * Run the conversion and print the timings to the standard output.
+         * @param arguments Command line arguments, including the program name.
+         * @return One of the exit codes.
+         */
+        int exec(const QStringList& arguments);
+    };
+}
@@ -0,0 +1,345 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/ProjectFile.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <boost/assert.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+
+#include <qdatetime.h>
+#include <qelapsedtimer.h>
+
+#include <zip.hpp>
+
+#include "element/CalendarObjectFactory.hpp"
+#include "project/DesignWriter.hpp"
+#include "project/ZipBufferWriter.hpp"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#ifdef _DEBUG
+#include <qdebug.h>
+#endif // _DEBUG
+
+namespace
+{
+    /**
+     * @internal
+     * Flush a closed file from the system cache to disk.
+     * @param path Path of the file.
+     * @throw std::runtime_error if the file can't be flushed.
+     */
+    void syncFile(const std::filesystem::path& path)
+    {
+#ifdef _WIN32
+        int descriptor{ _wopen(path.c_str(), _O_RDWR | _O_BINARY) };
+        bool synced{ descriptor >= 0 && _commit(descriptor) == 0 };
+        if (descriptor >= 0)
+            _close(descriptor);
+#else
+        int descriptor{ ::open(path.c_str(), O_RDWR) };
+        bool synced{ descriptor >= 0 && ::fsync(descriptor) == 0 };
+        if (descriptor >= 0)
+            ::close(descriptor);
+#endif // _WIN32
+        if (!synced)
+            throw std::runtime_error{ "Unable to flush \"" + path.u8string() + "\" to disk" };
+    }
+
+    /**
+     * @internal
+     * Buffer allocated by pugixml's allocator, so it can be handed over to pugi::xml_document.
+     */
+    using EntryBuffer = std::unique_ptr<char, pugi::deallocation_function>;
+
+    /**
+     * @internal
+     * Decompress an entry of the archive directly into a single buffer, without intermediate copies.
+     * @param container Archive to read.
+     * @param name Name of the entry.
+     * @param size Receive the size of the entry.
+     * @throw std::runtime_error if the entry can't be read completely.
+     */
+    EntryBuffer readEntry(libzip::archive& container, const std::string& name, std::size_t& size)
+    {
+        libzip::stat stat{ container.stat(name) };
+        size = static_cast<std::size_t>(stat.size);
+
+        // Allocate at least one byte, pugixml treats a null buffer as an allocation failure.
+        EntryBuffer buffer{ static_cast<char*>(pugi::get_memory_allocation_function()(size > 0 ? size : 1)),
+            pugi::get_memory_deallocation_function() };
+        if (buffer == nullptr)
+            throw std::bad_alloc{};
+
+        auto file = container.open(stat.index);
+        std::size_t offset{ 0 };
+        while (offset < size)
+        {
+            auto count = file.read(buffer.get() + offset, static_cast<std::uint64_t>(size - offset));
+            if (count <= 0)
+                throw std::runtime_error{ "Unable to read \"" + name + "\" from the project file." };
+            offset += static_cast<std::size_t>(count);
+        }
+        return buffer;
+    }
+
+    /**
+     * @internal
+     * Determine if the archive contains an entry.
+     */
+    bool hasEntry(libzip::archive& container, const std::string& name)
+    {
+        try
+        {
+            container.stat(name);
+            return true;
+        }
+        catch (const std::runtime_error&)
+        {
+            return false;
+        }
+    }
+}
+
+namespace project
+{
+    ProjectFile::ProjectFile(const QString& path)
+    {
+        libzip::archive container{ path.toStdString() };
+
+        std::size_t size{ 0 };
+
+        boost::property_tree::ptree metaIni;
+        {
+            auto metaBuffer = readEntry(container, "_meta/meta.ini", size);
+            boost::iostreams::stream<boost::iostreams::array_source> metaStream{ metaBuffer.get(), size };
+            boost::property_tree::ini_parser::read_ini(metaStream, metaIni);
+        }
+
+        auto specVer = QString::fromStdString(metaIni.get<std::string>("spec.version"));
+        auto appId = QString::fromStdString(metaIni.get<std::string>("app.uid"));
+        auto fileVersion = QString::fromStdString(metaIni.get<std::string>("file.version"));
+        if (appId != SimpleCalendarCreator::app_uid)
+            throw std::runtime_error{ "Simple Calendar Creator is unable to open this file." };
+
+        if (specVer > "1.0.0" || fileVersion > SimpleCalendarCreator::file_version)
+            throw std::runtime_error{ "Unable to open file, it's designed for newer program" };
+
+        createdTime = QString::fromStdString(metaIni.get<std::string>("file.created", ""));
+
+        if (hasEntry(container, "design.bin"))
+        {
+            binaryDesign = readEntry(container, "design.bin", size);
+            designReader = std::make_unique<DesignReader>(binaryDesign.get(), size);
+            properties.selectedYear = designReader->getSelectedYear();
+            properties.szCalendar = designReader->getSize();
+            return;
+        }
+
+        // The document takes the ownership of the buffer and parses it in place, even if parsing fails.
+        auto designBuffer = readEntry(container, "design.xml", size);
+        auto result = document.load_buffer_inplace_own(designBuffer.release(), size);
+        if (result.status != pugi::xml_parse_status::status_ok)
+            throw std::runtime_error{ result.description() };
+
+        auto project = document.first_child().child("project");
+        properties.selectedYear = project.child("target-year").text().as_int(1997);
+
+        auto projectSize = project.child("size");
+        properties.szCalendar = QSize{
+            projectSize.attribute("w").as_int(),
+            projectSize.attribute("h").as_int()
+        };
+    }
+
+    const CalendarProperties& ProjectFile::getProperties() const noexcept
+    {
+        return properties;
+    }
+
+    void ProjectFile::loadObjects(const ObjectReceiver& receiver, const ProgressReceiver& progress) const
+    {
+        BOOST_ASSERT_MSG(receiver != nullptr, "receiver must not be nullptr");
+
+        CalendarObjectFactory factory;
+        int loaded{ 0 };
+        if (designReader != nullptr)
+        {
+            int total{ static_cast<int>(designReader->getObjectCount()) };
+            designReader->rewind();
+            QString type;
+            QString name;
+            while (designReader->nextObject(&type, &name))
+            {
+                try
+                {
+                    auto object = receiver(name, factory.createObject(type));
+                    object->deserialize(designReader.get());
+                }
+                catch (const std::out_of_range & e)
+                {
+#ifdef _DEBUG
+                    qDebug() << e.what();
+#endif // _DEBUG
+                }
+                if (progress != nullptr && !progress(++loaded, total)) return;
+            }
+            return;
+        }
+
+        auto objects = document.first_child().children("calendar_obj");
+        int total{ static_cast<int>(std::distance(objects.begin(), objects.end())) };
+        for (auto itr : objects)
+        {
+            try
+            {
+                auto object = receiver(itr.attribute("name").as_string(),
+                    factory.createObject(itr.attribute("type").as_string()));
+                object->deserialize(itr);
+            }
+            catch (const std::out_of_range & e)
+            {
+#ifdef _DEBUG
+                qDebug() << e.what();
+#endif // _DEBUG
+            }
+            if (progress != nullptr && !progress(++loaded, total)) return;
+        }
+    }
+
+    ProjectFile::Encoding ProjectFile::getEncoding() const noexcept
+    {
+        return designReader == nullptr ? Encoding::xml : Encoding::binary;
+    }
+
+    const QString& ProjectFile::getCreatedTime() const noexcept
+    {
+        return createdTime;
+    }
+
+    ProjectFile::SaveStatistics ProjectFile::save(const QString& path, const CalendarProperties& properties,
+        const std::vector<NamedObject>& objects, Encoding encoding, const QString& createdTime)
+    {
+        QString modTime{ QDateTime::currentDateTimeUtc().toString(Qt::DateFormat::ISODate) };
+
+        boost::property_tree::ptree meta;
+        meta.add("spec.version", "1.0.0");
+        meta.add("app.uid", SimpleCalendarCreator::app_uid);
+        meta.add("app.version", SimpleCalendarCreator::app_version);
+        meta.add("file.version", encoding == Encoding::binary ?
+            SimpleCalendarCreator::file_version : ProjectFile::xml_file_version);
+        meta.add("file.modified", modTime.toStdString());
+
+        if (createdTime.isEmpty())
+            meta.add("file.created", modTime.toStdString());
+        else
+            meta.add("file.created", createdTime.toStdString());
+
+        SaveStatistics statistics{};
+        QElapsedTimer timer;
+        timer.start();
+
+        ZipBufferWriter metaWriter;
+        {
+            boost::iostreams::stream<ZipBufferWriter::Sink> metaStream{
+                ZipBufferWriter::Sink{ &metaWriter } };
+            boost::property_tree::ini_parser::write_ini(metaStream, meta);
+        }
+
+        ZipBufferWriter designWriter;
+        if (encoding == Encoding::binary)
+        {
+            DesignWriter writer{ properties };
+            for (const auto& [name, object] : objects)
+            {
+                BOOST_ASSERT_MSG(object != nullptr, "object must not be nullptr");
+                writer.beginObject(QString::fromStdString(element::Element::getTypeName(*object)), name);
+                object->serialize(&writer);
+                writer.endObject();
+            }
+            writer.writeTo(&designWriter);
+        }
+        else
+        {
+            pugi::xml_document document;
+            auto declaration = document.append_child(pugi::xml_node_type::node_declaration);
+            declaration.append_attribute("version").set_value("1.0");
+            declaration.append_attribute("encoding").set_value("utf-8");
+
+            auto design = document.append_child("design");
+            auto project = design.append_child("project");
+            project.append_child("target-year").text().set(properties.selectedYear);
+            auto projectSize = project.append_child("size");
+            projectSize.append_attribute("w").set_value(properties.szCalendar.width());
+            projectSize.append_attribute("h").set_value(properties.szCalendar.height());
+
+            for (const auto& [name, object] : objects)
+            {
+                BOOST_ASSERT_MSG(object != nullptr, "object must not be nullptr");
+                auto objectNode = design.append_child("calendar_obj");
+                objectNode.append_attribute("name").set_value(name.toUtf8().data());
+                object->serialize(&objectNode);
+            }
+            document.save(designWriter, "    ");
+        }
+        statistics.designSize = designWriter.getSize();
+        statistics.serializeTime = timer.restart();
+
+        // The new archive is written next to the original and replaces it only once it is complete, so the
+        // original is intact if saving is interrupted.
+        auto targetPath = std::filesystem::u8path(path.toUtf8().toStdString());
+        auto tempPath = std::filesystem::u8path(
+            (path + ProjectFile::temp_file_suffix).toUtf8().toStdString());
+        std::error_code ignored;
+        try
+        {
+            {
+                libzip::archive output{ tempPath.u8string(), ZIP_CREATE | ZIP_TRUNCATE };
+                output.add(metaWriter.release(), "_meta/meta.ini");
+                output.add(designWriter.release(),
+                    encoding == Encoding::binary ? "design.bin" : "design.xml");
+                statistics.stageTime = timer.restart();
+                // libzip compresses the staged entries and writes the archive when it is closed.
+            }
+            // Otherwise the rename may reach the disk before the data, and a crash leaves an empty project.
+            syncFile(tempPath);
+        }
+        catch (const std::exception&)
+        {
+            std::filesystem::remove(tempPath, ignored);
+            throw;
+        }
+        statistics.writeTime = timer.restart();
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, targetPath, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, ignored);
+            throw std::runtime_error{ "Unable to replace \"" + path.toStdString() + "\": " +
+                error.message() };
+        }
+        statistics.writeTime += timer.elapsed();
+        return statistics;
+    }
+}
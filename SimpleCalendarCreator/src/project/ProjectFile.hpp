@@ -0,0 +1,155 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <qstring.h>
+
+#include <pugixml.hpp>
+
+#include "element/Element.hpp"
+#include "project/DesignReader.hpp"
+#include "window/SimpleCalendarCreator.hpp"
+
+namespace project
+{
+    /**
+     * @brief Loader of the calendar design file (*.calendar).
+     *
+     * Shared by the main window and the headless batch renderer so both read a design the same way. The
+     * loader does not create any widget, it only parse the file and create calendar objects.
+     *
+     * Each entry of the archive is decompressed once into a buffer owned by the parsed document, which is
+     * parsed in place without intermediate copies.
+     *
+     * The design is stored either as XML (design.xml) or as the compact binary encoding of
+     * project::DesignWriter (design.bin), both in the same zip container with the same metadata.
+     */
+    class ProjectFile
+    {
+    public:
+        /**
+         * Function that take the ownership of a newly created calendar object.
+         * @param name Name of the calendar object given by user.
+         * @param object The calendar object, not deserialized yet.
+         * @return Pointer to the calendar object to deserialize.
+         */
+        using ObjectReceiver = std::function<element::Element*(const QString& name,
+            std::unique_ptr<element::Element> object)>;
+        /**
+         * Calendar object to save, paired with the name given by user.
+         */
+        using NamedObject = std::pair<QString, element::Element*>;
+        /**
+         * Function notified after each calendar object is loaded.
+         * @param loaded Amount of objects loaded so far, including skipped objects.
+         * @param total Amount of objects in the design.
+         * @return false to stop loading the remaining objects.
+         */
+        using ProgressReceiver = std::function<bool(int loaded, int total)>;
+
+        /**
+         * @brief Encoding of the design in the project file.
+         */
+        enum class Encoding
+        {
+            xml,  /**< Human readable XML, design.xml. */
+            binary  /**< Compact binary encoding, design.bin. */
+        };
+
+        /**
+         * @brief Time spent on each stage of saving a project file.
+         */
+        struct SaveStatistics
+        {
+            std::size_t designSize;  /**< Size of the serialized design in bytes. */
+            qint64 serializeTime;  /**< Time to serialize the design in ms. */
+            qint64 stageTime;  /**< Time to open the archive and stage the entries in ms. */
+            qint64 writeTime;  /**< Time to compress, write and replace the archive in ms. */
+        };
+    public:
+        /** Suffix of the temporary file written while saving, next to the project file. */
+        static constexpr char* const temp_file_suffix{ ".saving" };
+        /** Version of the file format written by XML encoded projects, readable by older programs. */
+        static constexpr char* const xml_file_version{ "1.0.0" };
+    public:
+        /**
+         * Open and parse a calendar design file.
+         * @param path Path to the calendar design file.
+         * @throw std::runtime_error if the file can't be read or is not supported.
+         */
+        explicit ProjectFile(const QString& path);
+
+        /**
+         * Get the properties of the calendar design.
+         */
+        const CalendarProperties& getProperties() const noexcept;
+
+        /**
+         * Create all calendar objects of the design in z-order, from bottom to top. Objects with unknown type
+         * are skipped.
+         * @param receiver Function that take the ownership of each object before it is deserialized.
+         * @param progress Function notified after each object is deserialized, nullptr for no notification.
+         */
+        void loadObjects(const ObjectReceiver& receiver, const ProgressReceiver& progress = nullptr) const;
+        /**
+         * Get the encoding of the design.
+         */
+        Encoding getEncoding() const noexcept;
+        /**
+         * Get the time when the project file is created, in ISO 8601 format. Empty if unknown.
+         */
+        const QString& getCreatedTime() const noexcept;
+
+        /**
+         * Save a calendar design. The project file is written to a temporary file, flushed to disk and
+         * renamed over the existing file once complete, so an interrupted save or a crash never leave a
+         * partially written project file. Safe to call from worker thread with objects that are not used by
+         * other threads.
+         * @param path Path to save the project file.
+         * @param properties Properties of the calendar design.
+         * @param objects Calendar objects of the design in z-order, from bottom to top.
+         * @param encoding Encoding of the design.
+         * @param createdTime Time when the file is created, empty for a new project.
+         * @throw std::runtime_error if the file can't be written.
+         */
+        static SaveStatistics save(const QString& path, const CalendarProperties& properties,
+            const std::vector<NamedObject>& objects, Encoding encoding,
+            const QString& createdTime = QString{});
+
+    private:
+        /**
+         * @internal
+         * Properties of the calendar design.
+         */
+        CalendarProperties properties{ 1997, SimpleCalendarCreator::default_calender_size };
+        /**
+         * @internal
+         * Parsed design of the calendar, owns the decompressed buffer of design.xml. Empty if the design is
+         * binary encoded.
+         */
+        pugi::xml_document document;
+        /**
+         * @internal
+         * Decompressed buffer of design.bin, nullptr if the design is XML encoded.
+         */
+        std::unique_ptr<char, pugi::deallocation_function> binaryDesign{ nullptr, nullptr };
+        /**
+         * @internal
+         * Reader of binaryDesign, nullptr if the design is XML encoded.
+         */
+        std::unique_ptr<DesignReader> designReader{ nullptr };
+        /**
+         * @internal
+         * Time when the project file is created.
+         */
+        QString createdTime;
+    };
+}
@@ -0,0 +1,100 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/ProjectLoader.hpp"
+
+#include <exception>
+
+#include <boost/assert.hpp>
+
+namespace project
+{
+    ProjectLoader::ProjectLoader(const QString& path, QObject* parent):
+        QObject(parent), path(path)
+    {
+    }
+
+    ProjectLoader::~ProjectLoader() noexcept
+    {
+        cancel();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    const QString& ProjectLoader::getPath() const noexcept
+    {
+        return path;
+    }
+
+    const CalendarProperties& ProjectLoader::getProperties() const noexcept
+    {
+        return properties;
+    }
+
+    ProjectFile::Encoding ProjectLoader::getEncoding() const noexcept
+    {
+        return encoding;
+    }
+
+    bool ProjectLoader::isCancelled() const noexcept
+    {
+        return cancelled;
+    }
+
+    std::vector<ProjectLoader::LoadedObject> ProjectLoader::takeObjects()
+    {
+        std::vector<LoadedObject> objects;
+        std::lock_guard<std::mutex> lock{ loadedObjectsMutex };
+        objects.swap(loadedObjects);
+        return objects;
+    }
+
+    void ProjectLoader::start()
+    {
+        BOOST_ASSERT_MSG(!worker.joinable(), "loader is already started");
+        worker = std::thread{ [this]() {
+            QString result{ loadWorker() };
+            emit finished(result);
+        } };
+    }
+
+    void ProjectLoader::cancel() noexcept
+    {
+        cancelled = true;
+    }
+
+    QString ProjectLoader::loadWorker()
+    {
+        try
+        {
+            ProjectFile projectFile{ path };
+            properties = projectFile.getProperties();
+            encoding = projectFile.getEncoding();
+            emit opened();
+
+            projectFile.loadObjects([this](const QString& name, std::unique_ptr<element::Element> object) {
+                pendingObject = LoadedObject{ name, std::move(object) };
+                return pendingObject.second.get();
+            }, [this](int loaded, int total) {
+                if (pendingObject.second != nullptr)
+                {
+                    std::lock_guard<std::mutex> lock{ loadedObjectsMutex };
+                    loadedObjects.push_back(std::move(pendingObject));
+                    pendingObject = LoadedObject{};
+                }
+                emit objectLoaded(loaded, total);
+                return !cancelled;
+            });
+        }
+        catch (const std::exception& e)
+        {
+            return e.what();
+        }
+
+        if (cancelled)
+            return "Opening cancelled.";
+        return QString{};
+    }
+}
@@ -0,0 +1,151 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <qobject.h>
+#include <qstring.h>
+
+#include "project/ProjectFile.hpp"
+
+namespace project
+{
+    /**
+     * @brief Open a calendar design file on a worker thread.
+     *
+     * The file is read and parsed by project::ProjectFile, then calendar objects are created and deserialized
+     * one by one without parent, so they never touch any widget on the worker thread. Loaded objects are
+     * collected until the main thread takes them with takeObjects(), which let the object list fill in while
+     * the rest of the design is still loading.
+     */
+    class ProjectLoader : public QObject
+    {
+        Q_OBJECT
+    public:
+        /**
+         * Deserialized calendar object, paired with the name given by user.
+         */
+        using LoadedObject = std::pair<QString, std::unique_ptr<element::Element>>;
+    public:
+        /**
+         * Create new loader.
+         * @param path Path to the calendar design file.
+         * @param parent Parent of the loader.
+         */
+        explicit ProjectLoader(const QString& path, QObject* parent = nullptr);
+        /**
+         * Cancel the running load and wait for the worker thread to stop.
+         */
+        ~ProjectLoader() noexcept;
+
+        /**
+         * Get the path of the calendar design file.
+         */
+        const QString& getPath() const noexcept;
+        /**
+         * Get the properties of the calendar design, valid after opened() is emitted.
+         */
+        const CalendarProperties& getProperties() const noexcept;
+        /**
+         * Get the encoding of the design, valid after opened() is emitted.
+         */
+        ProjectFile::Encoding getEncoding() const noexcept;
+        /**
+         * Determine if cancel() is called.
+         */
+        bool isCancelled() const noexcept;
+        /**
+         * Take the calendar objects loaded since last call, in z-order.
+         */
+        std::vector<LoadedObject> takeObjects();
+
+        /**
+         * Start loading in background, finished() is emitted when done.
+         */
+        void start();
+        /**
+         * Request the running load to stop after the object that is being deserialized.
+         */
+        void cancel() noexcept;
+
+    signals:
+        /**
+         * @name Signals
+         * @{
+         */
+        /**
+         * Fired from worker thread when the file is parsed, before any object is loaded.
+         */
+        void opened();
+        /**
+         * Fired from worker thread when an object is loaded.
+         * @param loaded Amount of objects loaded so far, including objects of unknown type.
+         * @param total Amount of objects in the design.
+         */
+        void objectLoaded(int loaded, int total);
+        /**
+         * Fired from worker thread when the load started by start() is done.
+         * @param error Empty on success, otherwise the error message.
+         */
+        void finished(const QString& error);
+        /** @} */
+
+    private:
+        /**
+         * @internal
+         * Load the design, run on the worker thread.
+         * @return Empty string on success, otherwise the error message.
+         */
+        QString loadWorker();
+
+    private:
+        /**
+         * @internal
+         * Path to the calendar design file.
+         */
+        QString path;
+        /**
+         * @internal
+         * Properties of the calendar design, written by the worker before opened() is emitted.
+         */
+        CalendarProperties properties{ 1997, SimpleCalendarCreator::default_calender_size };
+        /**
+         * @internal
+         * Encoding of the design, written by the worker before opened() is emitted.
+         */
+        ProjectFile::Encoding encoding{ ProjectFile::Encoding::xml };
+        /**
+         * @internal
+         * Object that is being deserialized by the worker.
+         */
+        LoadedObject pendingObject;
+        /**
+         * @internal
+         * Objects loaded but not taken yet.
+         */
+        std::vector<LoadedObject> loadedObjects;
+        /**
+         * @internal
+         * Guard of loadedObjects.
+         */
+        std::mutex loadedObjectsMutex;
+        /**
+         * @internal
+         * Determine if the load is cancelled.
+         */
+        std::atomic<bool> cancelled{ false };
+        /**
+         * @internal
+         * Worker thread of the background load.
+         */
+        std::thread worker;
+    };
+}
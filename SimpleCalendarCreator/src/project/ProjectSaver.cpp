@@ -0,0 +1,81 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/ProjectSaver.hpp"
+
+#include <exception>
+
+#include <boost/assert.hpp>
+
+#include "element/CustomListWidgetItem.hpp"
+
+namespace project
+{
+    ProjectSaver::ProjectSaver(const QString& path, const CalendarProperties& properties,
+        std::vector<SnapshotObject> objects, ProjectFile::Encoding encoding, const QString& createdTime,
+        QObject* parent):
+        QObject(parent), path(path), properties(properties), objects(std::move(objects)), encoding(encoding),
+        createdTime(createdTime)
+    {
+    }
+
+    ProjectSaver::~ProjectSaver() noexcept
+    {
+        if (worker.joinable())
+            worker.join();
+    }
+
+    std::vector<ProjectSaver::SnapshotObject> ProjectSaver::snapshot(const QListWidget& list)
+    {
+        std::vector<SnapshotObject> objects;
+        objects.reserve(list.count());
+        for (int idx{ 0 }; idx < list.count(); idx++)
+        {
+            auto item = static_cast<const CustomListWidgetItem*>(list.item(idx));
+            const element::Element* element_{ item->getElement() };
+            if (element_ != nullptr)
+                objects.emplace_back(item->text(), element_->clone());
+        }
+        return objects;
+    }
+
+    const QString& ProjectSaver::getPath() const noexcept
+    {
+        return path;
+    }
+
+    const ProjectFile::SaveStatistics& ProjectSaver::getStatistics() const noexcept
+    {
+        return statistics;
+    }
+
+    void ProjectSaver::start()
+    {
+        BOOST_ASSERT_MSG(!worker.joinable(), "saver is already started");
+        worker = std::thread{ [this]() {
+            std::vector<ProjectFile::NamedObject> namedObjects;
+            namedObjects.reserve(objects.size());
+            for (const auto& [name, object] : objects)
+                namedObjects.emplace_back(name, object.get());
+
+            try
+            {
+                statistics = ProjectFile::save(path, properties, namedObjects, encoding, createdTime);
+            }
+            catch (const std::exception& e)
+            {
+                result = e.what();
+            }
+            emit finished(result);
+        } };
+    }
+
+    QString ProjectSaver::wait()
+    {
+        if (worker.joinable())
+            worker.join();
+        return result;
+    }
+}
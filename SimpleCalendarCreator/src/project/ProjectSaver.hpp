@@ -0,0 +1,133 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <qlistwidget.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include "project/ProjectFile.hpp"
+
+namespace project
+{
+    /**
+     * @brief Save a calendar design file on a worker thread.
+     *
+     * The saver owns a snapshot of the design, created with element::Element::clone() on the main thread. The
+     * snapshot only copies the properties of each object, which mostly share their data with the original
+     * until modified, so the user can keep editing while the snapshot is serialized and written by
+     * ProjectFile::save().
+     */
+    class ProjectSaver : public QObject
+    {
+        Q_OBJECT
+    public:
+        /**
+         * Snapshot of a calendar object, paired with the name given by user.
+         */
+        using SnapshotObject = std::pair<QString, std::unique_ptr<element::Element>>;
+    public:
+        /**
+         * Create new saver.
+         * @param path Path to save the project file.
+         * @param properties Properties of the calendar design.
+         * @param objects Snapshot of the calendar objects in z-order, see snapshot().
+         * @param encoding Encoding of the design.
+         * @param createdTime Time when the file is created, empty for a new project.
+         * @param parent Parent of the saver.
+         */
+        ProjectSaver(const QString& path, const CalendarProperties& properties,
+            std::vector<SnapshotObject> objects, ProjectFile::Encoding encoding, const QString& createdTime,
+            QObject* parent = nullptr);
+        /**
+         * Wait for the running save to finish.
+         */
+        ~ProjectSaver() noexcept;
+
+        /**
+         * Take a snapshot of all calendar objects held by the list of CustomListWidgetItem.
+         * @param list List of calendar objects in z-order.
+         */
+        static std::vector<SnapshotObject> snapshot(const QListWidget& list);
+
+        /**
+         * Get the path to save the project file.
+         */
+        const QString& getPath() const noexcept;
+        /**
+         * Get the time spent on each stage of the save, valid after finished.
+         */
+        const ProjectFile::SaveStatistics& getStatistics() const noexcept;
+
+        /**
+         * Start saving in background, finished() is emitted when done.
+         */
+        void start();
+        /**
+         * Block until the save started by start() is done.
+         * @return Empty string on success, otherwise the error message.
+         */
+        QString wait();
+
+    signals:
+        /**
+         * @name Signals
+         * @{
+         */
+        /**
+         * Fired from worker thread when the save started by start() is done.
+         * @param error Empty on success, otherwise the error message.
+         */
+        void finished(const QString& error);
+        /** @} */
+
+    private:
+        /**
+         * @internal
+         * Path to save the project file.
+         */
+        QString path;
+        /**
+         * @internal
+         * Properties of the calendar design.
+         */
+        CalendarProperties properties;
+        /**
+         * @internal
+         * Snapshot of the calendar objects.
+         */
+        std::vector<SnapshotObject> objects;
+        /**
+         * @internal
+         * Encoding of the design.
+         */
+        ProjectFile::Encoding encoding;
+        /**
+         * @internal
+         * Time when the file is created.
+         */
+        QString createdTime;
+        /**
+         * @internal
+         * Time spent on each stage of the save.
+         */
+        ProjectFile::SaveStatistics statistics{};
+        /**
+         * @internal
+         * Result of the save, written by the worker before finished() is emitted.
+         */
+        QString result;
+        /**
+         * @internal
+         * Worker thread of the background save.
+         */
+        std::thread worker;
+    };
+}
@@ -0,0 +1,68 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "project/ZipBufferWriter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+
+namespace project
+{
+    std::streamsize ZipBufferWriter::Sink::write(const char* data, std::streamsize size)
+    {
+        BOOST_ASSERT_MSG(writer != nullptr, "writer must not be nullptr");
+        writer->write(data, static_cast<std::size_t>(size));
+        return size;
+    }
+
+    ZipBufferWriter::~ZipBufferWriter() noexcept
+    {
+        std::free(buffer);
+    }
+
+    void ZipBufferWriter::write(const void* data, std::size_t size)
+    {
+        if (this->size + size > capacity)
+        {
+            std::size_t newCapacity{ std::max({ initial_capacity, capacity * 2, this->size + size }) };
+            auto newBuffer = static_cast<char*>(std::realloc(buffer, newCapacity));
+            if (newBuffer == nullptr)
+                throw std::bad_alloc{};
+            buffer = newBuffer;
+            capacity = newCapacity;
+        }
+        std::memcpy(buffer + this->size, data, size);
+        this->size += size;
+    }
+
+    std::size_t ZipBufferWriter::getSize() const noexcept
+    {
+        return size;
+    }
+
+    libzip::source ZipBufferWriter::release()
+    {
+        // libzip::source must be copyable, the buffer is shared until libzip take the ownership.
+        auto data = std::make_shared<std::unique_ptr<char, decltype(&std::free)>>(buffer, &std::free);
+        auto length = size;
+        buffer = nullptr;
+        size = 0;
+        capacity = 0;
+
+        return [data, length](struct zip* archive) -> struct zip_source* {
+            auto source = zip_source_buffer(archive, data->get(), length, 1);
+            if (source == nullptr)
+                throw std::runtime_error{ zip_strerror(archive) };
+            data->release();
+            return source;
+        };
+    }
+}
@@ -0,0 +1,87 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstddef>
+#include <ios>
+
+#include <boost/iostreams/categories.hpp>
+
+#include <pugixml.hpp>
+#include <zip.hpp>
+
+namespace project
+{
+    /**
+     * @brief Writer that collect the serialized content of a project file entry into a single buffer.
+     *
+     * The buffer is handed over to libzip as is, so the serialized content is never copied between the
+     * writer and the archive. Accept output of pugi::xml_document::save() directly and other stream based
+     * serializers via ZipBufferWriter::Sink.
+     */
+    class ZipBufferWriter : public pugi::xml_writer
+    {
+    public:
+        /**
+         * @brief Boost.Iostreams sink that append to a ZipBufferWriter.
+         */
+        struct Sink
+        {
+            using char_type = char;
+            using category = boost::iostreams::sink_tag;
+
+            /**
+             * Append data to the writer.
+             */
+            std::streamsize write(const char* data, std::streamsize size);
+
+            /**
+             * Writer to append, must not be nullptr.
+             */
+            ZipBufferWriter* writer;
+        };
+    public:
+        /** Initial capacity of the buffer in bytes. */
+        static constexpr std::size_t initial_capacity{ 64 * 1024 };
+    public:
+        ZipBufferWriter() = default;
+        ZipBufferWriter(const ZipBufferWriter&) = delete;
+        ZipBufferWriter& operator=(const ZipBufferWriter&) = delete;
+        ~ZipBufferWriter() noexcept override;
+
+        /**
+         * Append data to the buffer.
+         * @throw std::bad_alloc if the buffer can't grow.
+         */
+        void write(const void* data, std::size_t size) override;
+        /**
+         * Get the number of bytes written.
+         */
+        std::size_t getSize() const noexcept;
+        /**
+         * Create a zip source that take the ownership of the buffer, the writer is empty afterward. The
+         * buffer is freed by libzip once the archive is written, or when the source is destroyed without
+         * being used.
+         */
+        libzip::source release();
+
+    private:
+        /**
+         * @internal
+         * Buffer allocated with std::malloc, as required by zip_source_buffer to free it.
+         */
+        char* buffer{ nullptr };
+        /**
+         * @internal
+         * Number of bytes written.
+         */
+        std::size_t size{ 0 };
+        /**
+         * @internal
+         * Number of bytes allocated.
+         */
+        std::size_t capacity{ 0 };
+    };
+}
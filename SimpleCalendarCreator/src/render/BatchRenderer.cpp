@@ -0,0 +1,237 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/BatchRenderer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <qcommandlineparser.h>
+#include <qdir.h>
+#include <qelapsedtimer.h>
+#include <qfile.h>
+#include <qimage.h>
+#include <qregularexpression.h>
+
+#include "project/ProjectFile.hpp"
+#include "render/CalendarExporter.hpp"
+#include "render/MonthRenderer.hpp"
+#include "render/TextLayoutCache.hpp"
+#include "render/VectorExporter.hpp"
+
+namespace render
+{
+    bool BatchRenderer::isRequested(int argc, char* argv[]) noexcept
+    {
+        for (int idx{ 1 }; idx < argc; idx++)
+        {
+            if (std::strcmp(argv[idx], "--render") == 0)
+                return true;
+        }
+        return false;
+    }
+
+    int BatchRenderer::exec(const QStringList& arguments)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription("Export calendar design without user interface.");
+        parser.addHelpOption();
+        QCommandLineOption optRender{ "render", "Calendar design to export.", "project" };
+        QCommandLineOption optOut{ "out", "Directory to write the rendered months.", "dir" };
+        QCommandLineOption optYear{ "year", "Override the targeted year of the design.", "N" };
+        QCommandLineOption optSize{ "size", "Override the size of the design.", "WxH" };
+        QCommandLineOption optFormat{ "format", "Output format: png for raster images (default, see "
+            "--preset), pdf or svg.", "format", "png" };
+        QCommandLineOption optPreset{ "preset", "Raster export preset: png (default), png-fast, png-small, "
+            "jpeg or webp.", "preset", export_presets.front().id };
+        QCommandLineOption optFull{ "full", "Export every month, including months unchanged since last "
+            "export." };
+        QCommandLineOption optCompare{ "compare", "Compare the exported months with the images of the same "
+            "name in another directory, only for raster images.", "dir" };
+        QCommandLineOption optNoTextCache{ "no-text-cache", "Draw labels with QPainter::drawText() instead "
+            "of the cached layouts, to compare their output with --compare." };
+        parser.addOptions({ optRender, optOut, optYear, optSize, optFormat, optPreset, optFull, optCompare,
+            optNoTextCache });
+
+        auto usageError = [&parser](const QString& message) {
+            std::cerr << message.toStdString() << std::endl << parser.helpText().toStdString();
+            return BatchRenderer::exit_invalid_arguments;
+        };
+
+        if (!parser.parse(arguments))
+            return usageError(parser.errorText());
+        if (parser.isSet("help"))
+        {
+            std::cout << parser.helpText().toStdString();
+            return BatchRenderer::exit_success;
+        }
+        if (!parser.isSet(optRender) || !parser.isSet(optOut))
+            return usageError("Both --render and --out are required.");
+        QString format{ parser.value(optFormat).toLower() };
+        if (format != "png" && format != "pdf" && format != "svg")
+            return usageError(QString{ "Invalid format \"%1\"." }.arg(parser.value(optFormat)));
+        if (format != "png" && parser.isSet(optCompare))
+            return usageError("--compare is only available to raster images.");
+        const ExportPreset* preset{ findExportPreset(parser.value(optPreset).toStdString()) };
+        if (preset == nullptr)
+            return usageError(QString{ "Invalid preset \"%1\"." }.arg(parser.value(optPreset)));
+
+        TextLayoutCache::setEnabled(!parser.isSet(optNoTextCache));
+
+        QElapsedTimer timer;
+        timer.start();
+
+        CalendarProperties properties;
+        std::vector<std::unique_ptr<element::Element>> elements;
+        try
+        {
+            project::ProjectFile projectFile{ parser.value(optRender) };
+            properties = projectFile.getProperties();
+            projectFile.loadObjects([&elements](const QString&, std::unique_ptr<element::Element> object) {
+                elements.push_back(std::move(object));
+                return elements.back().get();
+            });
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Failed to load \"" << parser.value(optRender).toStdString() << "\": " << e.what()
+                << std::endl;
+            return BatchRenderer::exit_load_failed;
+        }
+        qint64 loadTime{ timer.restart() };
+
+        if (parser.isSet(optYear))
+        {
+            bool valid{ false };
+            properties.selectedYear = parser.value(optYear).toInt(&valid);
+            if (!valid || !QDate::isValid(properties.selectedYear, 1, 1))
+                return usageError(QString{ "Invalid year \"%1\"." }.arg(parser.value(optYear)));
+        }
+        if (parser.isSet(optSize))
+        {
+            auto match = QRegularExpression{ "^(\\d+)x(\\d+)$" }.match(parser.value(optSize));
+            properties.szCalendar = match.hasMatch() ?
+                QSize{ match.captured(1).toInt(), match.captured(2).toInt() } : QSize{};
+            if (properties.szCalendar.isEmpty())
+                return usageError(QString{ "Invalid size \"%1\"." }.arg(parser.value(optSize)));
+        }
+
+        QString outputDir{ parser.value(optOut) };
+        if (!QDir{}.mkpath(outputDir))
+        {
+            std::cerr << "Unable to create output directory \"" << outputDir.toStdString() << "\""
+                << std::endl;
+            return BatchRenderer::exit_export_failed;
+        }
+
+        auto renderer = std::make_shared<const MonthRenderer>(std::move(elements), properties.szCalendar,
+            format == "png");
+        if (format != "png")
+        {
+            VectorExporter exporter{ std::move(renderer), properties.selectedYear };
+            try
+            {
+                if (format == "pdf")
+                    exporter.exportPdf(QString{ "%1/%2" }.arg(outputDir).arg(exporter.getPdfFileName()));
+                else
+                    exporter.exportSvg(outputDir);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return BatchRenderer::exit_export_failed;
+            }
+            std::cout << "load: " << loadTime << " ms" << std::endl
+                << "export: " << timer.elapsed() << " ms" << std::endl;
+            return BatchRenderer::exit_success;
+        }
+
+        CalendarExporter exporter{ std::move(renderer), properties.selectedYear, outputDir, *preset };
+        exporter.setIncremental(!parser.isSet(optFull));
+        QString error{ exporter.run() };
+        qint64 exportTime{ timer.elapsed() };
+
+        std::cout << "load: " << loadTime << " ms" << std::endl
+            << "export: " << exportTime << " ms" << std::endl
+            << exporter.getReport().toStdString() << std::endl;
+        if (!error.isEmpty())
+        {
+            std::cerr << error.toStdString() << std::endl;
+            return BatchRenderer::exit_export_failed;
+        }
+        if (parser.isSet(optCompare) &&
+            !compare(outputDir, parser.value(optCompare), preset->format, properties.selectedYear))
+        {
+            return BatchRenderer::exit_compare_failed;
+        }
+        return BatchRenderer::exit_success;
+    }
+
+    bool BatchRenderer::compare(const QString& outputDir, const QString& referenceDir, const char* extension,
+        int year)
+    {
+        bool identical{ true };
+        for (int month{ 1 }; month <= CalendarExporter::month_count; month++)
+        {
+            QString fileName{ CalendarExporter::getFileName(QDate{ year, month, 1 }, extension) };
+            QFile output{ QString{ "%1/%2" }.arg(outputDir).arg(fileName) };
+            QFile reference{ QString{ "%1/%2" }.arg(referenceDir).arg(fileName) };
+            if (!output.open(QIODevice::ReadOnly) || !reference.open(QIODevice::ReadOnly))
+            {
+                std::cout << fileName.toStdString() << ": missing" << std::endl;
+                identical = false;
+                continue;
+            }
+            QByteArray outputData{ output.readAll() };
+            QByteArray referenceData{ reference.readAll() };
+            if (outputData == referenceData)
+            {
+                std::cout << fileName.toStdString() << ": identical file" << std::endl;
+                continue;
+            }
+
+            //Files may differ in encoder settings only, compare the decoded pixels.
+            QImage outputImage{ QImage::fromData(outputData).convertToFormat(QImage::Format_ARGB32) };
+            QImage referenceImage{ QImage::fromData(referenceData).convertToFormat(QImage::Format_ARGB32) };
+            if (outputImage.isNull() || outputImage.size() != referenceImage.size())
+            {
+                std::cout << fileName.toStdString() << ": different size" << std::endl;
+                identical = false;
+                continue;
+            }
+
+            qint64 differentPixels{ 0 };
+            int maxDifference{ 0 };
+            for (int y{ 0 }; y < outputImage.height(); y++)
+            {
+                auto outputLine = reinterpret_cast<const QRgb*>(outputImage.constScanLine(y));
+                auto referenceLine = reinterpret_cast<const QRgb*>(referenceImage.constScanLine(y));
+                for (int x{ 0 }; x < outputImage.width(); x++)
+                {
+                    if (outputLine[x] == referenceLine[x]) continue;
+                    differentPixels++;
+                    maxDifference = std::max({ maxDifference,
+                        std::abs(qRed(outputLine[x]) - qRed(referenceLine[x])),
+                        std::abs(qGreen(outputLine[x]) - qGreen(referenceLine[x])),
+                        std::abs(qBlue(outputLine[x]) - qBlue(referenceLine[x])),
+                        std::abs(qAlpha(outputLine[x]) - qAlpha(referenceLine[x])) });
+                }
+            }
+            if (differentPixels == 0)
+            {
+                std::cout << fileName.toStdString() << ": identical pixels" << std::endl;
+                continue;
+            }
+            std::cout << fileName.toStdString() << ": " << differentPixels << " pixels differ, up to "
+                << maxDifference << " per channel" << std::endl;
+            identical = false;
+        }
+        return identical;
+    }
+}
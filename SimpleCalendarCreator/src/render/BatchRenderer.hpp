@@ -0,0 +1,62 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <qstringlist.h>
+
+namespace render
+{
+    /**
+     * @brief Command line mode that export a calendar design without creating any widget.
+     *
+     * Usage: SimpleCalendarCreator --render <project.calendar> --out <dir> [--year N] [--size WxH]
+     *
+     * The design is loaded by project::ProjectFile and exported by CalendarExporter, the same code path used
+     * by the main window. It must run under a QGuiApplication, usually with the "offscreen" platform.
+     *
+     * With --compare <dir>, the exported months are compared with the images of the same name in another
+     * directory, such as the output of an older version, and any difference fails the run. Exporting once
+     * with --no-text-cache and again with --compare against it checks the labels of Dates and WeakTitle drawn
+     * by TextLayoutCache against QPainter::drawText().
+     */
+    class BatchRenderer
+    {
+    public:
+        /** Exit code when the calendar is exported. */
+        static constexpr int exit_success{ 0 };
+        /** Exit code when the command line arguments are invalid. */
+        static constexpr int exit_invalid_arguments{ 1 };
+        /** Exit code when the calendar design can't be loaded. */
+        static constexpr int exit_load_failed{ 2 };
+        /** Exit code when the calendar can't be exported. */
+        static constexpr int exit_export_failed{ 3 };
+        /** Exit code when the exported months differ from the reference images, see --compare. */
+        static constexpr int exit_compare_failed{ 4 };
+    public:
+        /**
+         * Determine if the batch mode is requested by the command line, usable before the application
+         * object is created.
+         */
+        static bool isRequested(int argc, char* argv[]) noexcept;
+        /**
+         * Run the batch mode and print the timings to the standard output.
+         * @param arguments Command line arguments, including the program name.
+         * @return One of the exit codes.
+         */
+        int exec(const QStringList& arguments);
+
+    private:
+        /**
+         * @internal
+         * Compare the exported months with the reference images and print the result of each month.
+         * @param outputDir Directory of the exported months.
+         * @param referenceDir Directory of the reference images.
+         * @param extension Extension of the exported months.
+         * @param year Targeted year of the exported months.
+         * @return true if every month is identical to its reference in pixels.
+         */
+        bool compare(const QString& outputDir, const QString& referenceDir, const char* extension, int year);
+    };
+}
@@ -0,0 +1,118 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+#include <boost/assert.hpp>
+
+namespace render
+{
+    /**
+     * @brief Blocking FIFO queue with fixed capacity that connect two stages of a pipeline.
+     *
+     * Producers block while the queue is full and consumers block while it is empty, so the amount of items
+     * in flight between two stages never exceed the capacity. Closing the queue wakes up every waiting
+     * thread; consumers still receive the remaining items before pop() reports the end of the queue.
+     * @tparam T Type of item, must be movable.
+     */
+    template <typename T>
+    class BoundedQueue
+    {
+    public:
+        /**
+         * Create new queue.
+         * @param capacity Maximum amount of items held by the queue, must be greater than 0.
+         */
+        explicit BoundedQueue(std::size_t capacity):
+            capacity(capacity)
+        {
+            BOOST_ASSERT_MSG(capacity > 0, "capacity must be greater than 0");
+        }
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /**
+         * Append an item, block while the queue is full.
+         * @retval false if the queue has been closed, the item is dropped.
+         */
+        bool push(T value)
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+            if (closed) return false;
+
+            items.push_back(std::move(value));
+            lock.unlock();
+            notEmpty.notify_one();
+            return true;
+        }
+
+        /**
+         * Take the first item, block while the queue is empty.
+         * @return std::nullopt if the queue has been closed and no item left.
+         */
+        std::optional<T> pop()
+        {
+            std::unique_lock<std::mutex> lock{ mutex };
+            notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+            if (items.empty()) return std::nullopt;
+
+            std::optional<T> value{ std::move(items.front()) };
+            items.pop_front();
+            lock.unlock();
+            notFull.notify_one();
+            return value;
+        }
+
+        /**
+         * Stop accepting new items and wake up all waiting threads.
+         */
+        void close() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock{ mutex };
+                closed = true;
+            }
+            notFull.notify_all();
+            notEmpty.notify_all();
+        }
+
+    private:
+        /**
+         * @internal
+         * Maximum amount of items held by the queue.
+         */
+        std::size_t capacity{ 1 };
+        /**
+         * @internal
+         * Determine if the queue has been closed.
+         */
+        bool closed{ false };
+        /**
+         * @internal
+         * Items in the queue.
+         */
+        std::deque<T> items;
+        /**
+         * @internal
+         * Lock of the queue.
+         */
+        std::mutex mutex;
+        /**
+         * @internal
+         * Signaled when an item is taken from the queue.
+         */
+        std::condition_variable notFull;
+        /**
+         * @internal
+         * Signaled when an item is appended to the queue.
+         */
+        std::condition_variable notEmpty;
+    };
+}
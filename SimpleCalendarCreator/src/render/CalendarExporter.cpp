@@ -0,0 +1,438 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/CalendarExporter.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#include <boost/assert.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <QBuffer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageWriter>
+#include <QLocale>
+#include <QStringList>
+#include <QThread>
+
+#include "element/PropertiesHash.hpp"
+#include "render/PngStreamWriter.hpp"
+
+namespace render
+{
+    CalendarExporter::CalendarExporter(std::shared_ptr<const MonthRenderer> renderer, int year,
+        const QString& outputDir, const ExportPreset& preset, QObject* parent):
+        QObject(parent), renderer(std::move(renderer)), year(year), outputDir(outputDir), preset(preset)
+    {
+        BOOST_ASSERT_MSG(this->renderer != nullptr, "renderer must not be nullptr");
+    }
+
+    CalendarExporter::~CalendarExporter() noexcept
+    {
+        cancel();
+        if (controller.joinable())
+            controller.join();
+    }
+
+    QString CalendarExporter::getFileName(const QDate& date, const char* extension)
+    {
+        QLocale locale{ QLocale::Language::English, QLocale::Country::UnitedKingdom };
+        return QString{ "%1 %2.%3" }.arg(QString::number(date.month())).arg(locale.toString(date, "MMMM"))
+            .arg(extension);
+    }
+
+    bool CalendarExporter::isIncremental() const noexcept
+    {
+        return incremental;
+    }
+
+    void CalendarExporter::setIncremental(bool value) noexcept
+    {
+        incremental = value;
+    }
+
+    int CalendarExporter::getSkippedCount() const noexcept
+    {
+        return skipped;
+    }
+
+    std::array<StageStatistics, 3> CalendarExporter::getStatistics() const
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        return statistics;
+    }
+
+    std::array<qint64, CalendarExporter::month_count> CalendarExporter::getEncodeTimes() const
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        return encodeTimes;
+    }
+
+    QString CalendarExporter::getReport() const
+    {
+        QStringList report;
+        for (const auto& itr : getStatistics())
+        {
+            if (itr.threads == 0) continue;
+            double seconds{ std::max(itr.end - itr.begin, qint64{ 1 }) / 1e6 };
+            QString line{ QString{ "%1: %2 months in %3 s (%4 months/s" }.arg(itr.name).arg(itr.items)
+                .arg(seconds, 0, 'f', 2).arg(itr.items / seconds, 0, 'f', 1) };
+            if (itr.bytes > 0)
+                line += QString{ ", %1 MiB/s" }.arg(itr.bytes / seconds / (1024.0 * 1024.0), 0, 'f', 1);
+            line += QString{ ", %1 threads)" }.arg(itr.threads);
+            report.push_back(std::move(line));
+        }
+
+        QStringList monthTimes;
+        for (qint64 itr : getEncodeTimes())
+            monthTimes.push_back(QString::number(itr / 1000.0, 'f', 1));
+        report.push_back(QString{ "%1 per month: %2 ms" }.arg(preset.id).arg(monthTimes.join(", ")));
+        if (skipped > 0)
+            report.push_back(QString{ "skipped %1 unchanged months" }.arg(skipped));
+        return report.join('\n');
+    }
+
+    void CalendarExporter::start()
+    {
+        BOOST_ASSERT_MSG(!controller.joinable(), "exporter is already running");
+        controller = std::thread{ [this]() {
+            auto result = run();
+            emit finished(result);
+        } };
+    }
+
+    QString CalendarExporter::run()
+    {
+        nextMonth = 0;
+        exported = 0;
+        skipped = 0;
+        startTime = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            error.clear();
+            encodeTimes.fill(0);
+            if (!QImageWriter::supportedImageFormats().contains(preset.format))
+                return QString{ "Image format \"%1\" is not supported." }.arg(preset.format);
+            if (renderer->isStripRendered() && preset.compressionLevel < 0)
+            {
+                return QString{ "Designs larger than %1 pixels can only be exported as PNG." }
+                    .arg(MonthRenderer::max_layer_pixels);
+            }
+        }
+
+        readManifest();
+        if (renderer->isStripRendered())
+            runStrips();
+        else
+            runPipeline();
+        writeManifest();
+
+        std::lock_guard<std::mutex> guard{ lock };
+        if (error.isEmpty() && cancelled)
+            return "Export cancelled.";
+        return error;
+    }
+
+    std::string CalendarExporter::formatHash(element::PropertiesHash hash)
+    {
+        return QString{ "%1" }.arg(static_cast<qulonglong>(hash), 16, 16, QChar{ '0' }).toStdString();
+    }
+
+    void CalendarExporter::readManifest()
+    {
+        boost::property_tree::ptree manifest;
+        if (incremental)
+        {
+            try
+            {
+                boost::property_tree::ini_parser::read_ini(QString{ "%1/%2" }.arg(outputDir)
+                    .arg(CalendarExporter::manifest_file_name).toLocal8Bit().toStdString(), manifest);
+            }
+            catch (const boost::property_tree::ini_parser_error&)
+            {
+                manifest.clear();  //No manifest yet or unreadable, export every month.
+            }
+
+            //Hashes of another manifest version or renderer are not comparable, export every month.
+            if (manifest.get("export.version", 0) != CalendarExporter::manifest_version ||
+                manifest.get("export.renderer", 0) != MonthRenderer::render_version)
+            {
+                manifest.clear();
+            }
+        }
+
+        std::lock_guard<std::mutex> guard{ lock };
+        for (int month{ 0 }; month < CalendarExporter::month_count; month++)
+        {
+            QDate date{ year, month + 1, 1 };
+            element::PropertiesHash hash{ renderer->hash(date) };
+            element::hashCombine(hash, year);
+            element::hashCombine(hash, QString{ preset.id });
+            element::hashCombine(hash, preset.quality);
+            element::hashCombine(hash, preset.compressionLevel);
+            monthHashes[month] = hash;
+
+            auto stored = manifest.get_optional<std::string>("months." + std::to_string(month + 1));
+            QFileInfo output{ QString{ "%1/%2" }.arg(outputDir)
+                .arg(CalendarExporter::getFileName(date, preset.format)) };
+            skippedMonths[month] = stored.has_value() && *stored == CalendarExporter::formatHash(hash) &&
+                output.isFile();
+            doneMonths[month] = skippedMonths[month];
+        }
+    }
+
+    void CalendarExporter::writeManifest()
+    {
+        boost::property_tree::ptree manifest;
+        manifest.put("export.version", CalendarExporter::manifest_version);
+        manifest.put("export.renderer", MonthRenderer::render_version);
+        manifest.put("export.preset", preset.id);
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            for (int month{ 0 }; month < CalendarExporter::month_count; month++)
+            {
+                if (doneMonths[month])
+                {
+                    manifest.put("months." + std::to_string(month + 1),
+                        CalendarExporter::formatHash(monthHashes[month]));
+                }
+            }
+        }
+
+        try
+        {
+            boost::property_tree::ini_parser::write_ini(QString{ "%1/%2" }.arg(outputDir)
+                .arg(CalendarExporter::manifest_file_name).toLocal8Bit().toStdString(), manifest);
+        }
+        catch (const boost::property_tree::ini_parser_error& e)
+        {
+            fail(QString{ "Failed to write export manifest: %1" }.arg(e.what()));
+        }
+    }
+
+    void CalendarExporter::monthDone(const QDate& date)
+    {
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            doneMonths[date.month() - 1] = true;
+        }
+        reportProgress();
+    }
+
+    void CalendarExporter::monthSkipped()
+    {
+        skipped++;
+        reportProgress();
+    }
+
+    void CalendarExporter::reportProgress()
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        emit monthExported(++exported);
+    }
+
+    void CalendarExporter::runPipeline()
+    {
+        int idealThreads{ std::max(QThread::idealThreadCount(), 1) };
+        int renderThreads{ std::clamp(idealThreads / 2, 1, CalendarExporter::month_count) };
+        int encodeThreads{ std::clamp(idealThreads - renderThreads, 1, CalendarExporter::month_count) };
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            statistics = { {
+                { "render", renderThreads, 0, 0, 0, 0 },
+                { "encode", encodeThreads, 0, 0, 0, 0 },
+                { "write", 1, 0, 0, 0, 0 }
+            } };
+        }
+
+        BoundedQueue<RenderedMonth> encodeQueue{ static_cast<std::size_t>(encodeThreads) };
+        BoundedQueue<EncodedMonth> writeQueue{ CalendarExporter::write_queue_capacity };
+
+        std::vector<std::thread> renderers;
+        renderers.reserve(renderThreads);
+        for (int idx{ 0 }; idx < renderThreads; idx++)
+            renderers.emplace_back(&CalendarExporter::renderWorker, this, &encodeQueue);
+
+        std::vector<std::thread> encoders;
+        encoders.reserve(encodeThreads);
+        for (int idx{ 0 }; idx < encodeThreads; idx++)
+            encoders.emplace_back(&CalendarExporter::encodeWorker, this, &encodeQueue, &writeQueue);
+
+        std::thread writer{ &CalendarExporter::writeWorker, this, &writeQueue };
+
+        for (auto& itr : renderers)
+            itr.join();
+        encodeQueue.close();
+        for (auto& itr : encoders)
+            itr.join();
+        writeQueue.close();
+        writer.join();
+    }
+
+    void CalendarExporter::runStrips()
+    {
+        int threads{ std::clamp(QThread::idealThreadCount(), 1, CalendarExporter::month_count) };
+        {
+            std::lock_guard<std::mutex> guard{ lock };
+            statistics = { {
+                { "render to file", threads, 0, 0, 0, 0 },
+                { "encode", 0, 0, 0, 0, 0 },
+                { "write", 0, 0, 0, 0, 0 }
+            } };
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int idx{ 0 }; idx < threads; idx++)
+            workers.emplace_back(&CalendarExporter::stripWorker, this);
+        for (auto& itr : workers)
+            itr.join();
+    }
+
+    void CalendarExporter::cancel() noexcept
+    {
+        cancelled = true;
+    }
+
+    void CalendarExporter::renderWorker(BoundedQueue<RenderedMonth>* output)
+    {
+        for (int month{ nextMonth++ }; month < CalendarExporter::month_count && !cancelled;
+            month = nextMonth++)
+        {
+            QDate date{ year, month + 1, 1 };
+            if (skippedMonths[month])
+            {
+                monthSkipped();
+                continue;
+            }
+
+            qint64 begin{ elapsed() };
+            QImage image{ renderer->render(date, preset.hasAlpha ? Qt::GlobalColor::transparent :
+                Qt::GlobalColor::white) };
+            record(Stage::render_stage, begin, image.sizeInBytes());
+            if (!output->push(RenderedMonth{ date, std::move(image) }))
+                return;
+        }
+    }
+
+    void CalendarExporter::encodeWorker(BoundedQueue<RenderedMonth>* input,
+        BoundedQueue<EncodedMonth>* output)
+    {
+        //Keep draining the queue after cancelled, so the render stage is never blocked on a full queue.
+        while (auto month = input->pop())
+        {
+            if (cancelled) continue;
+
+            qint64 begin{ elapsed() };
+            QByteArray data;
+            QBuffer buffer{ &data };
+            buffer.open(QIODevice::OpenModeFlag::WriteOnly);
+            QImageWriter writer{ &buffer, preset.format };
+            writer.setQuality(preset.getWriterQuality());
+            if (!writer.write(month->image))
+            {
+                fail(QString{ "Failed to encode \"%1\": %2" }
+                    .arg(CalendarExporter::getFileName(month->date, preset.format))
+                    .arg(writer.errorString()));
+                continue;
+            }
+            buffer.close();
+            month->image = QImage{};
+            record(Stage::encode_stage, begin, data.size());
+            setEncodeTime(month->date, begin);
+
+            output->push(EncodedMonth{ month->date, std::move(data) });
+        }
+    }
+
+    void CalendarExporter::writeWorker(BoundedQueue<EncodedMonth>* input)
+    {
+        while (auto month = input->pop())
+        {
+            if (cancelled) continue;
+
+            qint64 begin{ elapsed() };
+            QString path{ QString{ "%1/%2" }.arg(outputDir)
+                .arg(CalendarExporter::getFileName(month->date, preset.format)) };
+            QFile file{ path };
+            if (!file.open(QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Truncate) ||
+                file.write(month->data) != month->data.size() || !file.flush())
+            {
+                fail(QString{ "Failed to write \"%1\": %2" }.arg(path).arg(file.errorString()));
+                continue;
+            }
+            file.close();
+            record(Stage::write_stage, begin, month->data.size());
+            monthDone(month->date);
+        }
+    }
+
+    void CalendarExporter::stripWorker()
+    {
+        for (int month{ nextMonth++ }; month < CalendarExporter::month_count && !cancelled;
+            month = nextMonth++)
+        {
+            QDate date{ year, month + 1, 1 };
+            if (skippedMonths[month])
+            {
+                monthSkipped();
+                continue;
+            }
+
+            qint64 begin{ elapsed() };
+            try
+            {
+                PngStreamWriter writer{ QString{ "%1/%2" }.arg(outputDir)
+                    .arg(CalendarExporter::getFileName(date)), preset.compressionLevel };
+                renderer->renderStrips(date, &writer);
+                record(Stage::render_stage, begin, writer.getBytesWritten());
+                setEncodeTime(date, begin);
+            }
+            catch (const std::exception& e)
+            {
+                fail(QString{ e.what() });
+                return;
+            }
+            monthDone(date);
+        }
+    }
+
+    qint64 CalendarExporter::elapsed() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+            startTime).count();
+    }
+
+    void CalendarExporter::record(Stage stage, qint64 begin, qint64 bytes)
+    {
+        qint64 end{ elapsed() };
+        std::lock_guard<std::mutex> guard{ lock };
+        auto& target = statistics[stage];
+        if (target.items == 0 || begin < target.begin)
+            target.begin = begin;
+        target.end = std::max(target.end, end);
+        target.items++;
+        target.bytes += bytes;
+    }
+
+    void CalendarExporter::setEncodeTime(const QDate& date, qint64 begin)
+    {
+        qint64 end{ elapsed() };
+        std::lock_guard<std::mutex> guard{ lock };
+        encodeTimes[date.month() - 1] = end - begin;
+    }
+
+    void CalendarExporter::fail(const QString& message)
+    {
+        std::lock_guard<std::mutex> guard{ lock };
+        if (error.isEmpty())
+            error = message;
+        cancelled = true;
+    }
+}
@@ -0,0 +1,356 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <QByteArray>
+#include <QDate>
+#include <QImage>
+#include <QObject>
+#include <QString>
+
+#include "render/BoundedQueue.hpp"
+#include "render/ExportPreset.hpp"
+#include "render/MonthRenderer.hpp"
+
+namespace render
+{
+    /**
+     * @brief Throughput statistics of a stage of the export pipeline.
+     */
+    struct StageStatistics
+    {
+        const char* name;  /**< Name of the stage. */
+        int threads;  /**< Amount of worker threads of the stage. */
+        int items;  /**< Amount of months processed by the stage. */
+        qint64 bytes;  /**< Amount of bytes produced by the stage. */
+        qint64 begin;  /**< Time when the stage started its first month, in microseconds. */
+        qint64 end;  /**< Time when the stage finished its last month, in microseconds. */
+    };
+
+    /**
+     * @brief Export engine that render, encode and write all months of a year as a pipeline.
+     *
+     * Each stage runs on its own worker threads, connected by BoundedQueue so that the rendering of a month
+     * overlap with the PNG compression and the disk write of previous months, while the amount of months
+     * held in memory stay capped by the queues' capacity. The result of each month is the same regardless
+     * of the number of worker threads.
+     *
+     * The hash of each exported month is stored in a manifest in the output directory, as 64 bits hex stable
+     * across platforms and builds. When exporting incrementally, months whose hash and output file are
+     * unchanged since the last export are skipped.
+     *
+     * Designs too large to hold a whole month in memory (see MonthRenderer::isStripRendered()) skip the
+     * pipeline, each worker renders a month in strips and streams them to PngStreamWriter as they are
+     * painted.
+     */
+    class CalendarExporter : public QObject
+    {
+        Q_OBJECT
+    public:
+        /** Amount of months to export. */
+        static constexpr int month_count{ 12 };
+        /** Amount of encoded months that may wait for the file writer. */
+        static constexpr std::size_t write_queue_capacity{ 4 };
+        /** Name of the manifest file in the output directory. */
+        static constexpr char* const manifest_file_name{ ".calendar_manifest.ini" };
+        /**
+         * Version of the manifest, a manifest of another version or written by another render_version of
+         * MonthRenderer is ignored and every month is exported again.
+         */
+        static constexpr int manifest_version{ 2 };
+    public:
+        /**
+         * Create new exporter.
+         * @param renderer Renderer that hold the snapshot of the design, must not be nullptr.
+         * @param year Targeted year to export.
+         * @param outputDir Directory to write the rendered months.
+         * @param preset Codec and encoding effort of the months.
+         * @param parent Parent of the exporter.
+         */
+        CalendarExporter(std::shared_ptr<const MonthRenderer> renderer, int year, const QString& outputDir,
+            const ExportPreset& preset = export_presets.front(), QObject* parent = nullptr);
+        /**
+         * Cancel the running export and wait for the worker threads to stop.
+         */
+        ~CalendarExporter() noexcept;
+
+        /**
+         * Get the file name of the rendered month, relative to the output directory.
+         * @param date Selected date, used month only.
+         * @param extension Extension of the file, without dot.
+         */
+        static QString getFileName(const QDate& date, const char* extension = "png");
+
+        /**
+         * Determine if unchanged months are skipped, enabled by default.
+         */
+        bool isIncremental() const noexcept;
+        /**
+         * Set if unchanged months are skipped, must not be called while exporting.
+         */
+        void setIncremental(bool value) noexcept;
+        /**
+         * Get amount of unchanged months skipped by the last export.
+         */
+        int getSkippedCount() const noexcept;
+
+        /**
+         * Get the throughput statistics of each stage of the last export.
+         */
+        std::array<StageStatistics, 3> getStatistics() const;
+        /**
+         * Get the time spent to encode each month of the last export in microseconds, 0 for months not
+         * encoded. Months of designs rendered in strips include their rendering time.
+         */
+        std::array<qint64, CalendarExporter::month_count> getEncodeTimes() const;
+        /**
+         * Get readable report of the throughput of each stage, one stage per line.
+         */
+        QString getReport() const;
+
+        /**
+         * Start exporting in background, finished() is emitted when done.
+         */
+        void start();
+        /**
+         * Export all months and block until done.
+         * @return Empty string on success, otherwise the error message.
+         */
+        QString run();
+        /**
+         * Request the running export to stop after the months that are being processed.
+         */
+        void cancel() noexcept;
+
+    signals:
+        /**
+         * @name Signals
+         * @{
+         */
+        /**
+         * Fired from worker thread when a month has been written.
+         * @param count Amount of months written so far.
+         */
+        void monthExported(int count);
+        /**
+         * Fired from worker thread when the background export started by start() is done.
+         * @param error Empty on success, otherwise the error message.
+         */
+        void finished(const QString& error);
+        /** @} */
+
+    private:
+        /**
+         * @internal
+         * Stages of the export pipeline, used as index of statistics.
+         */
+        enum Stage
+        {
+            render_stage,
+            encode_stage,
+            write_stage
+        };
+        /**
+         * @internal
+         * Month travelling from render stage to encode stage.
+         */
+        struct RenderedMonth
+        {
+            QDate date;
+            QImage image;
+        };
+        /**
+         * @internal
+         * Month travelling from encode stage to write stage.
+         */
+        struct EncodedMonth
+        {
+            QDate date;
+            QByteArray data;
+        };
+
+        /**
+         * @internal
+         * Format a hash as stored in the manifest.
+         */
+        static std::string formatHash(element::PropertiesHash hash);
+        /**
+         * @internal
+         * Compute the hash of each month and mark the months that are unchanged since the last export.
+         */
+        void readManifest();
+        /**
+         * @internal
+         * Store the hash of the months that are up to date in the output directory.
+         */
+        void writeManifest();
+        /**
+         * @internal
+         * Mark a month as written and report the progress.
+         */
+        void monthDone(const QDate& date);
+        /**
+         * @internal
+         * Count a month as skipped and report the progress.
+         */
+        void monthSkipped();
+        /**
+         * @internal
+         * Increase the progress and emit monthExported(), the only place it's emitted. Emitted under lock so
+         * the queued counts reach the receiver in increasing order.
+         */
+        void reportProgress();
+        /**
+         * @internal
+         * Export through the render, encode and write stages.
+         */
+        void runPipeline();
+        /**
+         * @internal
+         * Export a large design, each worker render and write whole months in strips.
+         */
+        void runStrips();
+        /**
+         * @internal
+         * Task of render stage, take next month and render it until no month left.
+         */
+        void renderWorker(BoundedQueue<RenderedMonth>* output);
+        /**
+         * @internal
+         * Task of encode stage, compress rendered months with the codec of the preset.
+         */
+        void encodeWorker(BoundedQueue<RenderedMonth>* input, BoundedQueue<EncodedMonth>* output);
+        /**
+         * @internal
+         * Task of write stage, write encoded months to output directory.
+         */
+        void writeWorker(BoundedQueue<EncodedMonth>* input);
+        /**
+         * @internal
+         * Task of large designs, take next month and stream its strips to file until no month left.
+         */
+        void stripWorker();
+        /**
+         * @internal
+         * Get the time elapsed since the export started, in microseconds.
+         */
+        qint64 elapsed() const;
+        /**
+         * @internal
+         * Record a month processed by a stage.
+         */
+        void record(Stage stage, qint64 begin, qint64 bytes);
+        /**
+         * @internal
+         * Record the time spent to encode a month.
+         */
+        void setEncodeTime(const QDate& date, qint64 begin);
+        /**
+         * @internal
+         * Keep the first error and stop the export.
+         */
+        void fail(const QString& message);
+
+    private:
+        /**
+         * @internal
+         * Renderer that hold snapshot of the design.
+         */
+        std::shared_ptr<const MonthRenderer> renderer{ nullptr };
+        /**
+         * @internal
+         * Targeted year to export.
+         */
+        int year{ 1997 };
+        /**
+         * @internal
+         * Directory to write the rendered months.
+         */
+        QString outputDir;
+        /**
+         * @internal
+         * Codec and encoding effort of the months.
+         */
+        ExportPreset preset;
+        /**
+         * @internal
+         * Determine if unchanged months are skipped.
+         */
+        bool incremental{ true };
+        /**
+         * @internal
+         * Hash of each month's output, see MonthRenderer::hash().
+         */
+        std::array<element::PropertiesHash, CalendarExporter::month_count> monthHashes;
+        /**
+         * @internal
+         * Determine if each month is unchanged and skipped, written before the workers start.
+         */
+        std::array<bool, CalendarExporter::month_count> skippedMonths;
+        /**
+         * @internal
+         * Determine if each month's output is up to date, guarded by lock.
+         */
+        std::array<bool, CalendarExporter::month_count> doneMonths;
+        /**
+         * @internal
+         * Amount of unchanged months skipped.
+         */
+        std::atomic_int skipped{ 0 };
+        /**
+         * @internal
+         * Index of next month to render, 0 as January.
+         */
+        std::atomic_int nextMonth{ 0 };
+        /**
+         * @internal
+         * Amount of months written.
+         */
+        std::atomic_int exported{ 0 };
+        /**
+         * @internal
+         * Determine if the export has been cancelled.
+         */
+        std::atomic_bool cancelled{ false };
+        /**
+         * @internal
+         * Time when the export started.
+         */
+        std::chrono::steady_clock::time_point startTime;
+        /**
+         * @internal
+         * Statistics of each stage, guarded by lock.
+         */
+        std::array<StageStatistics, 3> statistics;
+        /**
+         * @internal
+         * Time spent to encode each month, guarded by lock.
+         */
+        std::array<qint64, CalendarExporter::month_count> encodeTimes;
+        /**
+         * @internal
+         * First error occured on worker threads, guarded by lock.
+         */
+        QString error;
+        /**
+         * @internal
+         * Lock of statistics, encodeTimes, doneMonths and error.
+         */
+        mutable std::mutex lock;
+        /**
+         * @internal
+         * Background thread started by start().
+         */
+        std::thread controller;
+    };
+}
@@ -0,0 +1,58 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <array>
+#include <cmath>
+#include <string_view>
+
+namespace render
+{
+    /**
+     * @brief Codec and encoding effort of raster export.
+     */
+    struct ExportPreset
+    {
+        const char* id;  /**< Identifier of the preset, used by command line. */
+        const char* name;  /**< Readable name of the preset. */
+        const char* format;  /**< Format of QImageWriter, also the file extension. */
+        int quality;  /**< Quality of lossy formats from 0 to 100, -1 for lossless formats. */
+        int compressionLevel;  /**< Deflate level of PNG from 0 (fastest) to 9 (smallest), -1 otherwise. */
+        bool hasAlpha;  /**< Determine if the format keep transparency, otherwise white background. */
+
+        /**
+         * Get the value for QImageWriter::setQuality(), Qt's PNG writer derive its deflate level from
+         * quality.
+         */
+        int getWriterQuality() const
+        {
+            if (compressionLevel < 0) return quality;
+            return 100 - static_cast<int>(std::ceil(compressionLevel * 91.0 / 9.0));
+        }
+    };
+
+    /** Presets selectable for raster export, the first one is the default. */
+    constexpr std::array<ExportPreset, 5> export_presets{ {
+        { "png", "PNG images, balanced", "png", -1, 6, true },
+        { "png-fast", "PNG images, fastest (proofing)", "png", -1, 1, true },
+        { "png-small", "PNG images, smallest (archive)", "png", -1, 9, true },
+        { "jpeg", "JPEG images (web)", "jpg", 85, -1, false },
+        { "webp", "WebP images (web)", "webp", 80, -1, true }
+    } };
+
+    /**
+     * Find the export preset by its identifier.
+     * @return Pointer to the preset, nullptr if not found.
+     */
+    inline const ExportPreset* findExportPreset(std::string_view id)
+    {
+        for (const auto& itr : export_presets)
+        {
+            if (id == itr.id)
+                return &itr;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,163 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/MonthRenderer.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include <boost/assert.hpp>
+
+#include <QPainter>
+
+#include "element/CustomListWidgetItem.hpp"
+#include "element/PropertiesHash.hpp"
+
+namespace render
+{
+    MonthRenderer::MonthRenderer(std::vector<std::unique_ptr<element::Element>> elements, const QSize& size,
+        bool flattened):
+        elements(std::move(elements)), size(size)
+    {
+        if (!flattened || isStripRendered()) return;
+
+        auto staticBegin = this->elements.cbegin();
+        for (auto itr = this->elements.cbegin(); itr != this->elements.cend(); itr++)
+        {
+            if (!(*itr)->isDateDependent()) continue;
+
+            addStaticRun(staticBegin, itr);
+            layers.push_back({ QImage{}, itr->get() });
+            staticBegin = std::next(itr);
+        }
+        addStaticRun(staticBegin, this->elements.cend());
+    }
+
+    std::vector<std::unique_ptr<element::Element>> MonthRenderer::snapshot(const QListWidget& list)
+    {
+        std::vector<std::unique_ptr<element::Element>> elements;
+        elements.reserve(list.count());
+        for (int idx{ 0 }; idx < list.count(); idx++)
+        {
+            auto item = static_cast<const CustomListWidgetItem*>(list.item(idx));
+            const element::Element* element_{ item->getElement() };
+            if (element_ != nullptr)
+                elements.push_back(element_->clone());
+        }
+        return elements;
+    }
+
+    const QSize& MonthRenderer::getSize() const noexcept
+    {
+        return size;
+    }
+
+    bool MonthRenderer::isStripRendered() const noexcept
+    {
+        return static_cast<qint64>(size.width()) * size.height() > MonthRenderer::max_layer_pixels;
+    }
+
+    QImage MonthRenderer::render(const QDate& date, const QColor& background) const
+    {
+        return renderTile(date, QRect{ QPoint{ 0, 0 }, size }, 1.0, background);
+    }
+
+    QImage MonthRenderer::renderTile(const QDate& date, const QRect& tile, qreal scale,
+        const QColor& background) const
+    {
+        QImage canvas{ tile.size(), MonthRenderer::image_format };
+        canvas.fill(background);
+
+        QPainter painter{ &canvas };
+        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+        if (!tile.topLeft().isNull())
+            painter.translate(-tile.topLeft());
+
+        if (qFuzzyCompare(scale, 1.0) && !layers.empty())
+        {
+            for (const auto& itr : layers)
+            {
+                if (itr.element != nullptr)
+                    itr.element->paint(&painter, date);
+                else
+                    painter.drawImage(QPoint{ 0, 0 }, itr.image);
+            }
+        }
+        else
+        {
+            //Flattened layers are rasterized at scale of 1, paint every object again to stay sharp. Large
+            //designs and renderers created without flattening have no layers at all, the painter clip the
+            //objects to the tile.
+            painter.scale(scale, scale);
+            paint(&painter, date);
+        }
+        painter.end();
+
+        return canvas;
+    }
+
+    void MonthRenderer::paint(QPainter* painter, const QDate& date) const
+    {
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        painter->save();
+        for (const auto& itr : elements)
+            itr->paint(painter, date);
+        painter->restore();
+    }
+
+    void MonthRenderer::renderStrips(const QDate& date, ScanlineSink* sink, const QColor& background) const
+    {
+        BOOST_ASSERT_MSG(sink != nullptr, "sink must not be nullptr");
+        sink->begin(size);
+        for (int top{ 0 }; top < size.height(); top += MonthRenderer::strip_height)
+        {
+            QRect strip{ 0, top, size.width(), std::min(MonthRenderer::strip_height, size.height() - top) };
+            sink->write(renderTile(date, strip, 1.0, background));
+        }
+        sink->finish();
+    }
+
+    element::PropertiesHash MonthRenderer::hash(const QDate& date) const
+    {
+        element::PropertiesHash seed{ element::hashOf(size) };
+        for (const auto& itr : elements)
+        {
+            const element::Element& element_{ *itr };
+            element::hashCombine(seed, QString::fromStdString(element::Element::getTypeName(element_)));
+            element::hashCombine(seed, element_.hash(date));
+        }
+        return seed;
+    }
+
+    void MonthRenderer::addStaticRun(std::vector<std::unique_ptr<element::Element>>::const_iterator begin,
+        std::vector<std::unique_ptr<element::Element>>::const_iterator end)
+    {
+        if (begin == end) return;
+
+        if (flattenedCount < MonthRenderer::max_flattened_layers)
+        {
+            layers.push_back({ flatten(begin, end), nullptr });
+            flattenedCount++;
+            return;
+        }
+        for (auto itr = begin; itr != end; itr++)
+            layers.push_back({ QImage{}, itr->get() });
+    }
+
+    QImage MonthRenderer::flatten(std::vector<std::unique_ptr<element::Element>>::const_iterator begin,
+        std::vector<std::unique_ptr<element::Element>>::const_iterator end) const
+    {
+        QImage layer{ size, MonthRenderer::image_format };
+        layer.fill(Qt::GlobalColor::transparent);
+
+        QPainter painter{ &layer };
+        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+        for (auto itr = begin; itr != end; itr++)
+            (*itr)->paint(&painter, QDate{});
+        painter.end();
+
+        return layer;
+    }
+}
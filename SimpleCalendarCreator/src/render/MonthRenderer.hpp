@@ -0,0 +1,171 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <QColor>
+#include <QDate>
+#include <QImage>
+#include <QListWidget>
+#include <QRect>
+#include <QSize>
+
+#include "element/Element.hpp"
+#include "element/PropertiesHash.hpp"
+#include "render/ScanlineSink.hpp"
+
+namespace render
+{
+    /**
+     * @brief Compose months of a calendar design into images.
+     *
+     * The renderer owns a snapshot of the calendar objects, created with element::Element::clone(), and
+     * only paint them into QImage. It is therefore safe to render different months from several threads at
+     * once while the user keep editing the original design.
+     *
+     * A month is the same image whatever the thread rendering it. It is not byte-identical to the months of
+     * versions that composed a QPixmap per object, objects now paint straight into one canvas, so antialiased
+     * edges and text may differ slightly. Use BatchRenderer --compare to measure the difference of a design.
+     *
+     * Runs of date-invariant objects (see element::Element::isDateDependent()) are flattened into a cached
+     * layer when the renderer is created, so each month only repaint the date-dependent objects. As each
+     * layer is as large as the design, only the bottom max_flattened_layers runs are flattened and the
+     * objects of the runs above are painted one by one. Designs larger than max_layer_pixels are not
+     * flattened at all, such months should be rendered with renderStrips() to keep the memory bounded by the
+     * strip size.
+     */
+    class MonthRenderer
+    {
+    public:
+        /** Pixel format of the rendered months. */
+        static constexpr QImage::Format image_format{ QImage::Format_ARGB32_Premultiplied };
+        /** Maximum amount of pixels of a design to be flattened into layers, about 64 MiB per layer. */
+        static constexpr qint64 max_layer_pixels{ 4096 * 4096 };
+        /** Maximum amount of flattened layers of a renderer, which cap its memory to this many canvases. */
+        static constexpr int max_flattened_layers{ 2 };
+        /** Amount of rows of each strip rendered by renderStrips(). */
+        static constexpr int strip_height{ 256 };
+        /**
+         * Version of the rendering, increase it whenever the same design renders a different image so the
+         * months exported by older versions are no longer considered up to date.
+         */
+        static constexpr int render_version{ 1 };
+    public:
+        /**
+         * Create new renderer.
+         * @param elements Snapshot of calendar objects in z-order, from bottom to top.
+         * @param size Size of the calendar design.
+         * @param flattened Determine if runs of date-invariant objects are flattened into layers. Renderers
+         * only used by paint(), e.g. for vector output, should not spend the memory and time of flattening.
+         */
+        MonthRenderer(std::vector<std::unique_ptr<element::Element>> elements, const QSize& size,
+            bool flattened = true);
+
+        /**
+         * Take a snapshot of all calendar objects held by the list of CustomListWidgetItem.
+         * @param list List of calendar objects in z-order.
+         */
+        static std::vector<std::unique_ptr<element::Element>> snapshot(const QListWidget& list);
+
+        /**
+         * Get the size of the calendar design.
+         */
+        const QSize& getSize() const noexcept;
+        /**
+         * Determine if the design is too large to hold a whole month in memory, the months should be rendered
+         * with renderStrips().
+         */
+        bool isStripRendered() const noexcept;
+
+        /**
+         * Render the month of the selected date.
+         * @param date Selected date, used year and month only.
+         * @param background Colour to fill the canvas before painting the calendar objects.
+         */
+        QImage render(const QDate& date, const QColor& background = Qt::GlobalColor::transparent) const;
+        /**
+         * Render a region of the month of the selected date at any scale. Objects are painted as vector at
+         * the requested scale, so the tile stays sharp when zoomed in.
+         * @param date Selected date, used year and month only.
+         * @param tile Region to render, in pixels of the design scaled by @p scale.
+         * @param scale Scale of the design.
+         * @param background Colour to fill the tile before painting the calendar objects.
+         */
+        QImage renderTile(const QDate& date, const QRect& tile, qreal scale,
+            const QColor& background = Qt::GlobalColor::transparent) const;
+        /**
+         * Paint every object of the month of the selected date as vector on the caller's device, used for
+         * vector output.
+         * @param painter Active painter, must not be nullptr. Its state is restored before returning.
+         * @param date Selected date, used year and month only.
+         */
+        void paint(QPainter* painter, const QDate& date) const;
+        /**
+         * Render the month of the selected date from top to bottom in strips of strip_height rows. Only one
+         * strip is held in memory at a time, each is passed to the sink as soon as it is painted.
+         * @param date Selected date, used year and month only.
+         * @param sink Receiver of the strips, must not be nullptr.
+         * @param background Colour to fill the strips before painting the calendar objects.
+         * @throw std::runtime_error if the sink failed.
+         */
+        void renderStrips(const QDate& date, ScanlineSink* sink,
+            const QColor& background = Qt::GlobalColor::transparent) const;
+        /**
+         * Get the hash of everything that affects the rendered month, see element::Element::hash(). Stable
+         * across runs as long as render_version is unchanged.
+         * @param date Selected date, used year and month only.
+         */
+        element::PropertiesHash hash(const QDate& date) const;
+
+    private:
+        /**
+         * @internal
+         * Layer of the design, either flattened date-invariant objects or a single object painted for each
+         * month.
+         */
+        struct Layer
+        {
+            QImage image;  /**< Flattened date-invariant objects, null for layer of single object. */
+            const element::Element* element;  /**< Object painted each month, nullptr for flattened layer. */
+        };
+
+        /**
+         * @internal
+         * Add a run of date-invariant objects to layers, flattened while under max_flattened_layers.
+         */
+        void addStaticRun(std::vector<std::unique_ptr<element::Element>>::const_iterator begin,
+            std::vector<std::unique_ptr<element::Element>>::const_iterator end);
+        /**
+         * @internal
+         * Flatten a run of date-invariant objects into a layer.
+         */
+        QImage flatten(std::vector<std::unique_ptr<element::Element>>::const_iterator begin,
+            std::vector<std::unique_ptr<element::Element>>::const_iterator end) const;
+
+    private:
+        /**
+         * @internal
+         * Snapshot of calendar objects to render, from bottom to top.
+         */
+        std::vector<std::unique_ptr<element::Element>> elements;
+        /**
+         * @internal
+         * Layers to compose each month, from bottom to top.
+         */
+        std::vector<Layer> layers;
+        /**
+         * @internal
+         * Amount of flattened layers in layers.
+         */
+        int flattenedCount{ 0 };
+        /**
+         * @internal
+         * Size of the calendar design.
+         */
+        QSize size;
+    };
+}
@@ -0,0 +1,227 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/PngStreamWriter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+
+namespace render
+{
+    namespace
+    {
+        /** Bytes per pixel of 8 bits RGBA. */
+        constexpr std::size_t bytes_per_pixel{ 4 };
+        /** Amount of filter types defined by PNG. */
+        constexpr int filter_count{ 5 };
+
+        /** Append big-endian 32 bits integer. */
+        void appendUInt32(QByteArray* data, std::uint32_t value)
+        {
+            data->append(static_cast<char>((value >> 24) & 0xff));
+            data->append(static_cast<char>((value >> 16) & 0xff));
+            data->append(static_cast<char>((value >> 8) & 0xff));
+            data->append(static_cast<char>(value & 0xff));
+        }
+
+        /** Paeth predictor of PNG filter type 4. */
+        uchar paeth(int left, int up, int upLeft)
+        {
+            int estimate{ left + up - upLeft };
+            int distanceLeft{ std::abs(estimate - left) };
+            int distanceUp{ std::abs(estimate - up) };
+            int distanceUpLeft{ std::abs(estimate - upLeft) };
+            if (distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft)
+                return static_cast<uchar>(left);
+            if (distanceUp <= distanceUpLeft)
+                return static_cast<uchar>(up);
+            return static_cast<uchar>(upLeft);
+        }
+    }
+
+    PngStreamWriter::PngStreamWriter(const QString& path, int compressionLevel):
+        file(path), compressionLevel(std::clamp(compressionLevel, 0, 9))
+    {
+        if (!file.open(QIODevice::OpenModeFlag::WriteOnly | QIODevice::OpenModeFlag::Truncate))
+        {
+            throw std::runtime_error{ QString{ "Failed to open \"%1\": %2" }.arg(path).arg(file.errorString())
+                .toStdString() };
+        }
+    }
+
+    PngStreamWriter::~PngStreamWriter() noexcept
+    {
+        if (streamActive)
+            deflateEnd(&stream);
+    }
+
+    void PngStreamWriter::begin(const QSize& size)
+    {
+        BOOST_ASSERT_MSG(!size.isEmpty(), "size must not be empty");
+        BOOST_ASSERT_MSG(!streamActive, "image already began");
+        this->size = size;
+        rows = 0;
+
+        constexpr char signature[]{ "\x89PNG\r\n\x1a\n" };
+        writeData(signature, sizeof(signature) - 1);
+
+        QByteArray header;
+        appendUInt32(&header, static_cast<std::uint32_t>(size.width()));
+        appendUInt32(&header, static_cast<std::uint32_t>(size.height()));
+        header.append(static_cast<char>(8));  //Bit depth.
+        header.append(static_cast<char>(6));  //Colour type, RGBA.
+        header.append(static_cast<char>(0));  //Compression method, deflate.
+        header.append(static_cast<char>(0));  //Filter method, adaptive.
+        header.append(static_cast<char>(0));  //No interlace.
+        writeChunk("IHDR", header);
+
+        if (deflateInit(&stream, compressionLevel) != Z_OK)
+            throw std::runtime_error{ "Failed to initialize deflate stream" };
+        streamActive = true;
+
+        std::size_t rowSize{ static_cast<std::size_t>(size.width()) * bytes_per_pixel };
+        previous.assign(rowSize, 0);
+        filtered.resize(rowSize + 1);
+        candidate.resize(rowSize + 1);
+        idat.resize(PngStreamWriter::idat_chunk_size);
+        stream.next_out = reinterpret_cast<Bytef*>(idat.data());
+        stream.avail_out = PngStreamWriter::idat_chunk_size;
+    }
+
+    void PngStreamWriter::write(const QImage& strip)
+    {
+        BOOST_ASSERT_MSG(streamActive, "begin() must be called before writing rows");
+        BOOST_ASSERT_MSG(strip.width() == size.width(), "strip must have the width of the image");
+        BOOST_ASSERT_MSG(rows + strip.height() <= size.height(), "strip exceeds the image");
+
+        //RGBA8888 is stored as R, G, B, A bytes on every machine, which is the pixel layout of PNG.
+        QImage converted{ strip.convertToFormat(QImage::Format::Format_RGBA8888) };
+        for (int row{ 0 }; row < converted.height(); row++)
+        {
+            const uchar* line{ converted.constScanLine(row) };
+            filterRow(line);
+            deflateData(filtered.data(), filtered.size(), Z_NO_FLUSH);
+            std::copy(line, line + previous.size(), previous.begin());
+        }
+        rows += converted.height();
+    }
+
+    void PngStreamWriter::finish()
+    {
+        BOOST_ASSERT_MSG(rows == size.height(), "all rows must be written before finishing");
+        deflateData(nullptr, 0, Z_FINISH);
+        flushIdat();
+        deflateEnd(&stream);
+        streamActive = false;
+        writeChunk("IEND", QByteArray{});
+
+        if (!file.flush())
+        {
+            throw std::runtime_error{ QString{ "Failed to write \"%1\": %2" }.arg(file.fileName())
+                .arg(file.errorString()).toStdString() };
+        }
+        file.close();
+    }
+
+    qint64 PngStreamWriter::getBytesWritten() const noexcept
+    {
+        return bytesWritten;
+    }
+
+    void PngStreamWriter::filterRow(const uchar* row)
+    {
+        const std::size_t rowSize{ previous.size() };
+        const uchar* up{ previous.data() };
+        long bestSum{ -1 };
+        for (int type{ 0 }; type < filter_count; type++)
+        {
+            candidate[0] = static_cast<uchar>(type);
+            long sum{ 0 };
+            for (std::size_t idx{ 0 }; idx < rowSize; idx++)
+            {
+                int left{ idx >= bytes_per_pixel ? row[idx - bytes_per_pixel] : 0 };
+                int upLeft{ idx >= bytes_per_pixel ? up[idx - bytes_per_pixel] : 0 };
+                uchar predictor{ 0 };
+                switch (type)
+                {
+                case 1:
+                    predictor = static_cast<uchar>(left);
+                    break;
+                case 2:
+                    predictor = up[idx];
+                    break;
+                case 3:
+                    predictor = static_cast<uchar>((left + up[idx]) / 2);
+                    break;
+                case 4:
+                    predictor = paeth(left, up[idx], upLeft);
+                    break;
+                }
+                uchar value{ static_cast<uchar>(row[idx] - predictor) };
+                candidate[idx + 1] = value;
+                sum += std::abs(static_cast<signed char>(value));
+            }
+
+            if (bestSum < 0 || sum < bestSum)
+            {
+                bestSum = sum;
+                std::swap(filtered, candidate);
+            }
+        }
+    }
+
+    void PngStreamWriter::deflateData(const uchar* data, std::size_t length, int flush)
+    {
+        stream.next_in = const_cast<Bytef*>(data);
+        stream.avail_in = static_cast<uInt>(length);
+        int result{ Z_OK };
+        do
+        {
+            if (stream.avail_out == 0)
+                flushIdat();
+            result = deflate(&stream, flush);
+            if (result == Z_STREAM_ERROR)
+                throw std::runtime_error{ "Failed to compress image data" };
+        } while (stream.avail_in > 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    }
+
+    void PngStreamWriter::flushIdat()
+    {
+        int pending{ PngStreamWriter::idat_chunk_size - static_cast<int>(stream.avail_out) };
+        if (pending > 0)
+            writeChunk("IDAT", QByteArray::fromRawData(idat.constData(), pending));
+        stream.next_out = reinterpret_cast<Bytef*>(idat.data());
+        stream.avail_out = PngStreamWriter::idat_chunk_size;
+    }
+
+    void PngStreamWriter::writeChunk(const char* type, const QByteArray& data)
+    {
+        QByteArray header;
+        appendUInt32(&header, static_cast<std::uint32_t>(data.size()));
+        header.append(type, 4);
+
+        uLong crc{ crc32(0, reinterpret_cast<const Bytef*>(type), 4) };
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data.constData()), static_cast<uInt>(data.size()));
+        QByteArray footer;
+        appendUInt32(&footer, static_cast<std::uint32_t>(crc));
+
+        writeData(header.constData(), header.size());
+        writeData(data.constData(), data.size());
+        writeData(footer.constData(), footer.size());
+    }
+
+    void PngStreamWriter::writeData(const char* data, qint64 length)
+    {
+        if (file.write(data, length) != length)
+        {
+            throw std::runtime_error{ QString{ "Failed to write \"%1\": %2" }.arg(file.fileName())
+                .arg(file.errorString()).toStdString() };
+        }
+        bytesWritten += length;
+    }
+}
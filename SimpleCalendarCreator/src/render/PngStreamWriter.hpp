@@ -0,0 +1,144 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <QByteArray>
+#include <QFile>
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+#include <zlib.h>
+
+#include "render/ScanlineSink.hpp"
+
+namespace render
+{
+    /**
+     * @brief Write an image as PNG file while its rows arrive.
+     *
+     * Each row is filtered and deflated as soon as it is received and the compressed data is written to the
+     * file in IDAT chunks, so only one strip, the previous row and the deflate window are held in memory
+     * regardless of the size of the image. The image is stored as 8 bits RGBA.
+     */
+    class PngStreamWriter : public ScanlineSink
+    {
+    public:
+        /** Compression level used when none is given, same as zlib's default. */
+        static constexpr int default_compression_level{ 6 };
+        /** Maximum size of the data of an IDAT chunk. */
+        static constexpr int idat_chunk_size{ 64 * 1024 };
+    public:
+        /**
+         * Create new writer.
+         * @param path Path of the file to write, overwritten if exists.
+         * @param compressionLevel Compression level of deflate, from 0 (fastest) to 9 (smallest).
+         * @throw std::runtime_error if the file can't be opened.
+         */
+        explicit PngStreamWriter(const QString& path,
+            int compressionLevel = PngStreamWriter::default_compression_level);
+        PngStreamWriter(const PngStreamWriter&) = delete;
+        PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+        ~PngStreamWriter() noexcept;
+
+        void begin(const QSize& size) override;
+        void write(const QImage& strip) override;
+        void finish() override;
+
+        /**
+         * Get amount of bytes written to the file.
+         */
+        qint64 getBytesWritten() const noexcept;
+
+    private:
+        /**
+         * @internal
+         * Filter a row with the filter type that give the smallest sum of absolute difference, the filtered
+         * row is stored in filtered.
+         */
+        void filterRow(const uchar* row);
+        /**
+         * @internal
+         * Feed data to deflate and write the full IDAT chunks.
+         * @param flush Flush mode of deflate, Z_NO_FLUSH or Z_FINISH.
+         */
+        void deflateData(const uchar* data, std::size_t length, int flush);
+        /**
+         * @internal
+         * Write the compressed data held by idat as IDAT chunk.
+         */
+        void flushIdat();
+        /**
+         * @internal
+         * Write a chunk to the file.
+         */
+        void writeChunk(const char* type, const QByteArray& data);
+        /**
+         * @internal
+         * Write data to the file, throw std::runtime_error if failed.
+         */
+        void writeData(const char* data, qint64 length);
+
+    private:
+        /**
+         * @internal
+         * File to write.
+         */
+        QFile file;
+        /**
+         * @internal
+         * Compression level of deflate.
+         */
+        int compressionLevel{ PngStreamWriter::default_compression_level };
+        /**
+         * @internal
+         * Size of the image.
+         */
+        QSize size;
+        /**
+         * @internal
+         * Amount of rows written.
+         */
+        int rows{ 0 };
+        /**
+         * @internal
+         * Deflate stream of the image data.
+         */
+        z_stream stream{};
+        /**
+         * @internal
+         * Determine if stream has been initialized.
+         */
+        bool streamActive{ false };
+        /**
+         * @internal
+         * Previous unfiltered row, zeros before the first row.
+         */
+        std::vector<uchar> previous;
+        /**
+         * @internal
+         * Filter type followed by the filtered row.
+         */
+        std::vector<uchar> filtered;
+        /**
+         * @internal
+         * Candidate filtered row while choosing the filter.
+         */
+        std::vector<uchar> candidate;
+        /**
+         * @internal
+         * Compressed data waiting to be written as IDAT chunk.
+         */
+        QByteArray idat;
+        /**
+         * @internal
+         * Amount of bytes written to the file.
+         */
+        qint64 bytesWritten{ 0 };
+    };
+}
@@ -0,0 +1,53 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/PreviewCache.hpp"
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+namespace render
+{
+    void PreviewCache::update(const QListWidget& list, const QSize& size, std::uint64_t revision)
+    {
+        if (renderer != nullptr && this->revision == revision && renderer->getSize() == size)
+            return;
+
+        renderer = std::make_shared<const MonthRenderer>(MonthRenderer::snapshot(list), size);
+        this->revision = revision;
+        monthHashes.clear();
+    }
+
+    std::shared_ptr<const MonthRenderer> PreviewCache::getRenderer() const noexcept
+    {
+        return renderer;
+    }
+
+    element::PropertiesHash PreviewCache::getMonthHash(const QDate& date) const
+    {
+        BOOST_ASSERT_MSG(renderer != nullptr, "update() must be called before hashing months");
+
+        QDate month{ date.year(), date.month(), 1 };
+        auto itr = monthHashes.find(month);
+        if (itr == monthHashes.end())
+            itr = monthHashes.emplace(month, renderer->hash(month)).first;
+        return itr->second;
+    }
+
+    std::optional<QPixmap> PreviewCache::find(const TileKey& key) const
+    {
+        const Entry* entry{ tiles.object(key) };
+        if (entry == nullptr || entry->hash != getMonthHash(key.month))
+            return std::nullopt;
+        return entry->tile;
+    }
+
+    void PreviewCache::insert(const TileKey& key, element::PropertiesHash hash, const QPixmap& tile)
+    {
+        int cost{ std::max(1, tile.width() * tile.height() * tile.depth() / 8 / 1024) };
+        tiles.insert(key, new Entry{ hash, tile }, cost);
+    }
+}
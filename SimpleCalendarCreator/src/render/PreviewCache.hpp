@@ -0,0 +1,123 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+
+#include <QCache>
+#include <QDate>
+#include <QHash>
+#include <QListWidget>
+#include <QPair>
+#include <QPixmap>
+#include <QPoint>
+#include <QSize>
+
+#include "render/MonthRenderer.hpp"
+
+namespace render
+{
+    /**
+     * @brief Identity of a preview tile.
+     */
+    struct TileKey
+    {
+        QDate month;  /**< First day of the month. */
+        int level;  /**< Zoom level, the design is scaled by 2 to the power of level. */
+        QPoint tile;  /**< Column and row of the tile. */
+    };
+
+    /** Determine if two tile keys are equal. */
+    inline bool operator==(const TileKey& lhs, const TileKey& rhs)
+    {
+        return (lhs.month == rhs.month) && (lhs.level == rhs.level) && (lhs.tile == rhs.tile);
+    }
+
+    /** Hash of tile key, used by QCache. */
+    inline uint qHash(const TileKey& key, uint seed = 0)
+    {
+        return ::qHash(key.month, seed) ^ ::qHash(key.level, seed) ^
+            ::qHash(qMakePair(key.tile.x(), key.tile.y()), seed);
+    }
+
+    /**
+     * @brief Rendered tiles of the preview, kept across preview sessions.
+     *
+     * The snapshot of the design is only taken again when the document revision changed. Each cached tile
+     * stores the hash of the month it was rendered with, see MonthRenderer::hash(), so after a change only
+     * the months whose output is affected are rendered again.
+     */
+    class PreviewCache
+    {
+    public:
+        /** Maximum amount of memory used by rendered tiles, in KiB. */
+        static constexpr int max_cost_kib{ 64 * 1024 };
+    public:
+        /**
+         * Take a new snapshot of the design if it changed since the last update.
+         * @param list List of calendar objects in z-order.
+         * @param size Size of the calendar design.
+         * @param revision Revision of the document, see UndoHistory::getRevision().
+         */
+        void update(const QListWidget& list, const QSize& size, std::uint64_t revision);
+        /**
+         * Get the renderer of the latest snapshot, nullptr if update() has never been called.
+         */
+        std::shared_ptr<const MonthRenderer> getRenderer() const noexcept;
+        /**
+         * Get the hash of the month rendered by the latest snapshot.
+         * @param date Selected date, used year and month only.
+         */
+        element::PropertiesHash getMonthHash(const QDate& date) const;
+
+        /**
+         * Get the rendered tile if it is cached and still up to date with the latest snapshot.
+         */
+        std::optional<QPixmap> find(const TileKey& key) const;
+        /**
+         * Store a rendered tile.
+         * @param key Identity of the tile.
+         * @param hash Hash of the month the tile rendered with.
+         * @param tile Rendered tile.
+         */
+        void insert(const TileKey& key, element::PropertiesHash hash, const QPixmap& tile);
+
+    private:
+        /**
+         * @internal
+         * Cached tile with the hash of the month it was rendered with.
+         */
+        struct Entry
+        {
+            element::PropertiesHash hash;
+            QPixmap tile;
+        };
+
+    private:
+        /**
+         * @internal
+         * Revision of the document of the latest snapshot.
+         */
+        std::optional<std::uint64_t> revision;
+        /**
+         * @internal
+         * Renderer of the latest snapshot.
+         */
+        std::shared_ptr<const MonthRenderer> renderer{ nullptr };
+        /**
+         * @internal
+         * Hash of months computed from the latest snapshot, keyed by the first day of the month.
+         */
+        mutable std::map<QDate, element::PropertiesHash> monthHashes;
+        /**
+         * @internal
+         * Rendered tiles.
+         */
+        QCache<TileKey, Entry> tiles{ PreviewCache::max_cost_kib };
+    };
+}
@@ -0,0 +1,39 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <QImage>
+#include <QSize>
+
+namespace render
+{
+    /**
+     * @brief Interface of all receivers of a month rendered strip by strip.
+     *
+     * Strips are delivered from top to bottom and have the full width of the month, so a sink may encode
+     * and write the rows as they arrive without holding the whole month in memory. Sinks report errors by
+     * throwing std::runtime_error.
+     */
+    class ScanlineSink
+    {
+    public:
+        /**
+         * Start receiving a new image.
+         * @param size Size of the whole image.
+         */
+        virtual void begin(const QSize& size) = 0;
+        /**
+         * Receive the next strip of rows, below the previous strip.
+         * @param strip Rows of the image in MonthRenderer::image_format.
+         */
+        virtual void write(const QImage& strip) = 0;
+        /**
+         * Complete the image after its last strip.
+         */
+        virtual void finish() = 0;
+        virtual ~ScanlineSink() noexcept = 0;
+    };
+    inline ScanlineSink::~ScanlineSink() noexcept = default;
+}
@@ -0,0 +1,107 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/TextLayoutCache.hpp"
+
+#include <boost/assert.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <QFont>
+#include <QFontMetricsF>
+#include <QHash>
+#include <QPaintDevice>
+#include <QTextOption>
+
+namespace render
+{
+    std::atomic_bool TextLayoutCache::enabled{ true };
+
+    bool TextLayoutCache::isEnabled() noexcept
+    {
+        return enabled;
+    }
+
+    void TextLayoutCache::setEnabled(bool value) noexcept
+    {
+        enabled = value;
+    }
+
+    void TextLayoutCache::drawText(QPainter* painter, const QRect& rect, int flags, const QString& text)
+    {
+        BOOST_ASSERT_MSG(painter != nullptr, "painter must not be nullptr");
+        if (!enabled)
+        {
+            painter->drawText(rect, flags, text);
+            return;
+        }
+
+        //Layouts are device dependent, the same label is laid out differently for screen, PDF and SVG.
+        QPaintDevice* device{ painter->device() };
+        QFont font{ painter->font(), device };
+        auto& cache = getCache();
+        Key key{ painter->font().key(), device->logicalDpiX(), device->logicalDpiY(), text, rect.width(),
+            flags };
+        auto itr = cache.find(key);
+        if (itr == cache.end())
+        {
+            if (cache.size() >= TextLayoutCache::max_entries)
+                cache.clear();
+
+            //Horizontal alignment is done by the layout, vertical alignment is done while drawing.
+            QTextOption option{ static_cast<Qt::Alignment>(flags) & Qt::AlignmentFlag::AlignHorizontal_Mask };
+            option.setWrapMode(QTextOption::WrapMode::NoWrap);
+
+            QStaticText layout{ text };
+            layout.setTextFormat(Qt::TextFormat::PlainText);
+            layout.setTextOption(option);
+            layout.setTextWidth(rect.width());
+            layout.prepare(QTransform{}, font);
+            itr = cache.emplace(std::move(key), std::move(layout)).first;
+        }
+
+        //Aligned by the line height of the font as QPainter::drawText() does, not by the layout bounds.
+        qreal lineHeight{ QFontMetricsF{ font, device }.height() };
+        qreal y{ static_cast<qreal>(rect.y()) };
+        if (flags & Qt::AlignmentFlag::AlignVCenter)
+            y += (rect.height() - lineHeight) / 2.0;
+        else if (flags & Qt::AlignmentFlag::AlignBottom)
+            y += rect.height() - lineHeight;
+
+        bool clipped{ !(flags & Qt::TextFlag::TextDontClip) };
+        if (clipped)
+        {
+            painter->save();
+            painter->setClipRect(rect, Qt::ClipOperation::IntersectClip);
+        }
+        painter->drawStaticText(QPointF{ static_cast<qreal>(rect.x()), y }, itr->second);
+        if (clipped)
+            painter->restore();
+    }
+
+    bool TextLayoutCache::Key::operator==(const Key& rhs) const noexcept
+    {
+        return (width == rhs.width) && (flags == rhs.flags) && (dpiX == rhs.dpiX) && (dpiY == rhs.dpiY) &&
+            (text == rhs.text) && (font == rhs.font);
+    }
+
+    std::size_t TextLayoutCache::KeyHash::operator()(const Key& key) const noexcept
+    {
+        std::size_t seed{ 0 };
+        boost::hash_combine(seed, qHash(key.font));
+        boost::hash_combine(seed, key.dpiX);
+        boost::hash_combine(seed, key.dpiY);
+        boost::hash_combine(seed, qHash(key.text));
+        boost::hash_combine(seed, key.width);
+        boost::hash_combine(seed, key.flags);
+        return seed;
+    }
+
+    std::unordered_map<TextLayoutCache::Key, QStaticText, TextLayoutCache::KeyHash>&
+        TextLayoutCache::getCache() noexcept
+    {
+        thread_local std::unordered_map<Key, QStaticText, KeyHash> cache;
+        return cache;
+    }
+}
@@ -0,0 +1,91 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <unordered_map>
+
+#include <QPainter>
+#include <QRect>
+#include <QStaticText>
+#include <QString>
+
+namespace render
+{
+    /**
+     * @brief Cache of laid out labels, shared by calendar objects that draw the same short texts repeatedly.
+     *
+     * Texts are laid out once as QStaticText, keyed by font, device resolution, text, rect width and
+     * alignment flags, so drawing the same label again only blit its glyphs. Each thread has its own cache
+     * because QStaticText must not be shared between threads.
+     *
+     * The cache can be disabled with setEnabled() to draw with QPainter::drawText() instead, so the output of
+     * both can be compared, see BatchRenderer.
+     */
+    class TextLayoutCache
+    {
+    public:
+        /** Maximum amount of laid out texts kept by each thread, the cache is cleared when exceeded. */
+        static constexpr std::size_t max_entries{ 1024 };
+    public:
+        /**
+         * Determine if texts are drawn from the cache, enabled by default.
+         */
+        static bool isEnabled() noexcept;
+        /**
+         * Set if texts are drawn from the cache, affects every thread. Must not be called while rendering.
+         */
+        static void setEnabled(bool value) noexcept;
+        /**
+         * Draw a single line text aligned in the rect with painter's current font and pen, equivalent to
+         * QPainter::drawText(const QRect&, int, const QString&). The text is clipped to the rect unless
+         * Qt::TextDontClip is set.
+         * @param painter Painter to draw with, must not be nullptr.
+         * @param rect Area to align the text in.
+         * @param flags Alignment flags of the text.
+         * @param text Text to draw.
+         */
+        static void drawText(QPainter* painter, const QRect& rect, int flags, const QString& text);
+
+    private:
+        /**
+         * @internal
+         * Key of a laid out text.
+         */
+        struct Key
+        {
+            QString font;
+            int dpiX;
+            int dpiY;
+            QString text;
+            int width;
+            int flags;
+
+            bool operator==(const Key& rhs) const noexcept;
+        };
+        /**
+         * @internal
+         * Hasher of Key.
+         */
+        struct KeyHash
+        {
+            std::size_t operator()(const Key& key) const noexcept;
+        };
+
+        /**
+         * @internal
+         * Get the cache of the calling thread.
+         */
+        static std::unordered_map<Key, QStaticText, KeyHash>& getCache() noexcept;
+
+    private:
+        /**
+         * @internal
+         * Determine if texts are drawn from the cache.
+         */
+        static std::atomic_bool enabled;
+    };
+}
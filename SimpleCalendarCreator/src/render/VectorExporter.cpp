@@ -0,0 +1,150 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "render/VectorExporter.hpp"
+
+#include <stdexcept>
+
+#include <boost/assert.hpp>
+
+#include <QImage>
+#include <QMarginsF>
+#include <QPageLayout>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QRect>
+#include <QSvgGenerator>
+
+#include "render/CalendarExporter.hpp"
+
+namespace
+{
+    /**
+     * Get the logical resolution of the images painted by the raster export. Element fonts are sized in
+     * points, so the vector devices must use the same resolution to lay out text as the raster output does.
+     */
+    int getRasterResolution()
+    {
+        return QImage{ 1, 1, QImage::Format::Format_ARGB32_Premultiplied }.logicalDpiX();
+    }
+}
+
+namespace render
+{
+    VectorExporter::VectorExporter(std::shared_ptr<const MonthRenderer> renderer, int year, QObject* parent):
+        QObject(parent), renderer(std::move(renderer)), year(year)
+    {
+        BOOST_ASSERT_MSG(this->renderer != nullptr, "renderer must not be nullptr");
+    }
+
+    VectorExporter::~VectorExporter() noexcept
+    {
+        cancel();
+        if (controller.joinable())
+            controller.join();
+    }
+
+    QString VectorExporter::getPdfFileName() const
+    {
+        return QString{ "Calendar %1.pdf" }.arg(year);
+    }
+
+    void VectorExporter::exportPdf(const QString& path, int resolution)
+    {
+        BOOST_ASSERT_MSG(resolution > 0, "resolution must be greater than 0");
+        const QSize& size{ renderer->getSize() };
+        QSizeF pageSize{ size.width() * 72.0 / resolution, size.height() * 72.0 / resolution };
+        //Paint at the raster resolution and scale the design to the page, which keeps the physical page size.
+        int rasterResolution{ getRasterResolution() };
+        qreal scale{ static_cast<qreal>(rasterResolution) / resolution };
+
+        QPdfWriter writer{ path };
+        writer.setCreator("Simple Calendar Creator");
+        writer.setTitle(getPdfFileName());
+        writer.setResolution(rasterResolution);
+        writer.setPageLayout(QPageLayout{ QPageSize{ pageSize, QPageSize::Unit::Point, QString{},
+            QPageSize::SizeMatchPolicy::ExactMatch },
+            QPageLayout::Orientation::Portrait, QMarginsF{} });
+
+        QPainter painter;
+        if (!painter.begin(&writer))
+            throw std::runtime_error{ QString{ "Failed to write \"%1\"" }.arg(path).toStdString() };
+        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+        for (int month{ 0 }; month < VectorExporter::month_count; month++)
+        {
+            checkCancelled();
+            if (month > 0 && !writer.newPage())
+                throw std::runtime_error{ QString{ "Failed to write \"%1\"" }.arg(path).toStdString() };
+            painter.save();
+            painter.scale(scale, scale);
+            renderer->paint(&painter, QDate{ year, month + 1, 1 });
+            painter.restore();
+            emit monthExported(month + 1);
+        }
+        if (!painter.end())
+            throw std::runtime_error{ QString{ "Failed to write \"%1\"" }.arg(path).toStdString() };
+    }
+
+    void VectorExporter::exportSvg(const QString& outputDir)
+    {
+        const QSize& size{ renderer->getSize() };
+        int rasterResolution{ getRasterResolution() };
+        for (int month{ 0 }; month < VectorExporter::month_count; month++)
+        {
+            checkCancelled();
+            QDate date{ year, month + 1, 1 };
+            QString path{ QString{ "%1/%2" }.arg(outputDir).arg(CalendarExporter::getFileName(date, "svg")) };
+
+            QSvgGenerator generator;
+            generator.setFileName(path);
+            generator.setSize(size);
+            generator.setViewBox(QRect{ QPoint{ 0, 0 }, size });
+            generator.setResolution(rasterResolution);
+            generator.setTitle(CalendarExporter::getFileName(date, "svg"));
+
+            QPainter painter;
+            if (!painter.begin(&generator))
+                throw std::runtime_error{ QString{ "Failed to write \"%1\"" }.arg(path).toStdString() };
+            painter.setRenderHint(QPainter::RenderHint::Antialiasing);
+            renderer->paint(&painter, date);
+            if (!painter.end())
+                throw std::runtime_error{ QString{ "Failed to write \"%1\"" }.arg(path).toStdString() };
+            emit monthExported(month + 1);
+        }
+    }
+
+    void VectorExporter::start(VectorExporter::Format format, const QString& outputDir)
+    {
+        BOOST_ASSERT_MSG(!controller.joinable(), "exporter is already running");
+        cancelled = false;
+        controller = std::thread{ [this, format, outputDir]() {
+            QString result;
+            try
+            {
+                if (format == VectorExporter::Format::pdf)
+                    exportPdf(QString{ "%1/%2" }.arg(outputDir).arg(getPdfFileName()));
+                else
+                    exportSvg(outputDir);
+            }
+            catch (const std::exception& e)
+            {
+                result = e.what();
+            }
+            emit finished(result);
+        } };
+    }
+
+    void VectorExporter::cancel() noexcept
+    {
+        cancelled = true;
+    }
+
+    void VectorExporter::checkCancelled() const
+    {
+        if (cancelled)
+            throw std::runtime_error{ "Export cancelled." };
+    }
+}
@@ -0,0 +1,135 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include <QDate>
+#include <QObject>
+#include <QString>
+
+#include "render/MonthRenderer.hpp"
+
+namespace render
+{
+    /**
+     * @brief Export all months of a year as resolution-independent vector graphics.
+     *
+     * The calendar objects are painted with the same drawing code as the raster export, but on QPdfWriter or
+     * QSvgGenerator, so texts stay as texts and shapes as paths. Vector output does not depend on the size
+     * of the design, which make it far smaller and faster than raster output at print resolution.
+     *
+     * The renderer should be created without flattening, as only MonthRenderer::paint() is used.
+     */
+    class VectorExporter : public QObject
+    {
+        Q_OBJECT
+    public:
+        /** Amount of months to export. */
+        static constexpr int month_count{ 12 };
+        /** Resolution of the design used to size the PDF pages, in dots per inch. */
+        static constexpr int default_resolution{ 300 };
+
+        /**
+         * @brief Output format of the vector export.
+         */
+        enum class Format
+        {
+            pdf,  /**< One PDF document with a page per month. */
+            svg  /**< One SVG image per month. */
+        };
+    public:
+        /**
+         * Create new exporter.
+         * @param renderer Renderer that hold the snapshot of the design, must not be nullptr.
+         * @param year Targeted year to export.
+         * @param parent Parent of the exporter.
+         */
+        VectorExporter(std::shared_ptr<const MonthRenderer> renderer, int year, QObject* parent = nullptr);
+        /**
+         * Cancel the running export and wait for the worker thread to stop.
+         */
+        ~VectorExporter() noexcept;
+
+        /**
+         * Get the file name of the PDF document of the year.
+         */
+        QString getPdfFileName() const;
+
+        /**
+         * Write all months into one PDF document, one page per month.
+         * @param path Path of the PDF document, overwritten if exists.
+         * @param resolution Resolution of the design in dots per inch, the page size is the design size at
+         * this resolution.
+         * @throw std::runtime_error if the document can't be written.
+         */
+        void exportPdf(const QString& path, int resolution = VectorExporter::default_resolution);
+        /**
+         * Write each month as SVG image.
+         * @param outputDir Directory to write the images, named as the raster export.
+         * @throw std::runtime_error if any image can't be written.
+         */
+        void exportSvg(const QString& outputDir);
+
+        /**
+         * Start exporting in background, finished() is emitted when done.
+         * @param format Output format.
+         * @param outputDir Directory to write the output, the PDF document is named by getPdfFileName().
+         */
+        void start(VectorExporter::Format format, const QString& outputDir);
+        /**
+         * Request the running export to stop after the month that is being painted.
+         */
+        void cancel() noexcept;
+
+    signals:
+        /**
+         * @name Signals
+         * @{
+         */
+        /**
+         * Fired from worker thread when a month has been painted.
+         * @param count Amount of months painted so far.
+         */
+        void monthExported(int count);
+        /**
+         * Fired from worker thread when the background export started by start() is done.
+         * @param error Empty on success, otherwise the error message.
+         */
+        void finished(const QString& error);
+        /** @} */
+
+    private:
+        /**
+         * @internal
+         * Throw if the export has been cancelled.
+         */
+        void checkCancelled() const;
+
+    private:
+        /**
+         * @internal
+         * Renderer that hold snapshot of the design.
+         */
+        std::shared_ptr<const MonthRenderer> renderer{ nullptr };
+        /**
+         * @internal
+         * Targeted year to export.
+         */
+        int year{ 1997 };
+        /**
+         * @internal
+         * Determine if the export has been cancelled.
+         */
+        std::atomic_bool cancelled{ false };
+        /**
+         * @internal
+         * Background thread started by start().
+         */
+        std::thread controller;
+    };
+}
@@ -5,30 +5,37 @@
 ************************************************************************************************************/
 #include "window/PreviewWindow.hpp"
 
+#include <cmath>
+
+#include <boost/assert.hpp>
+
 #include <QAction>
 #include <QDate>
 #include <qevent.h>
-#include <QPainter>
 
-#include "element/CustomListWidgetItem.hpp"
+#include "render/MonthRenderer.hpp"
 
 #ifdef _DEBUG
 #include <qdebug.h>
 #endif // _DEBUG
 
-PreviewWindow::PreviewWindow(const QListWidget& list, int year, const QSize& size, QWidget *parent)
-    : QDialog(parent), selectedYear(year), szCalendar(size),ui(std::make_unique<Ui::PreviewWindow>())
+PreviewWindow::PreviewWindow(render::PreviewCache* cache, int year, QWidget *parent)
+    : QDialog(parent), selectedYear(year), ui(std::make_unique<Ui::PreviewWindow>()), cache(cache)
 {
+    BOOST_ASSERT_MSG(cache != nullptr && cache->getRenderer() != nullptr, "cache must be updated");
     ui->setupUi(this);
-    render(list);
+    renderer = cache->getRenderer();
+    szCalendar = renderer->getSize();
+    prefetcher = std::thread{ &PreviewWindow::prefetchWorker, this };
     connectObjects();
     initUi();
 }
 
 PreviewWindow::~PreviewWindow() noexcept
 {
-    if (previewPixmap != nullptr && previewPixmap->parentWidget() != nullptr)
-        delete previewPixmap;
+    closing = true;
+    prefetchQueue.close();
+    prefetcher.join();
 }
 
 void PreviewWindow::showEvent(QShowEvent* ev)
@@ -51,40 +58,80 @@ void PreviewWindow::connectObjects()
     connect(ui->zoomOut, &QPushButton::clicked, this, &PreviewWindow::onZoomOut);
 }
 
-void PreviewWindow::render(const QListWidget& list)
+void PreviewWindow::prefetch(int index)
 {
-    QPainter painter;
-    for (QDate date{ selectedYear, 1, 1 }; date.year() == selectedYear; date = date.addMonths(1))
+    QRectF visible{ ui->previewArea->mapToScene(ui->previewArea->viewport()->rect()).boundingRect() };
+    auto [level, tiles] = TiledMonthItem::getTiles(visible, ui->previewArea->transform().m11(), szCalendar);
+    if (tiles.isEmpty()) return;
+
+    for (int neighbour : { index + 1, index - 1 })
     {
-        QPixmap buffer{ szCalendar };
-        buffer.fill(Qt::GlobalColor::white);
-        painter.begin(&buffer);
+        if (neighbour < 0 || neighbour >= PreviewWindow::month_count) continue;
+        if (pendingMonths.count(neighbour) > 0) continue;
 
-        //Render all calendar object on to buffer
-        for (int idxItem{ 0 }; idxItem < list.count(); idxItem++)
+        QDate date{ selectedYear, neighbour + 1, 1 };
+        TileRequest request{ neighbour, level, {} };
+        for (int row{ tiles.top() }; row <= tiles.bottom(); row++)
         {
-            CustomListWidgetItem* item = static_cast<CustomListWidgetItem*>(list.item(idxItem));
-            element::Element* element_ = item->getElement();
-            if (element_ != nullptr)
+            for (int column{ tiles.left() }; column <= tiles.right(); column++)
             {
-                painter.drawPixmap(QRect{ QPoint{ 0, 0 }, szCalendar },
-                    element_->render(date));
+                QPoint tile{ column, row };
+                if (!cache->find(render::TileKey{ date, level, tile }).has_value())
+                    request.tiles.push_back(tile);
             }
         }
-        painter.end();
-        months.push_back(std::move(buffer));
+        if (request.tiles.empty()) continue;
+
+        pendingMonths.insert(neighbour);
+        prefetchQueue.push(std::move(request));
+    }
+}
+
+void PreviewWindow::prefetchWorker()
+{
+    while (auto request = prefetchQueue.pop())
+    {
+        QDate date{ selectedYear, request->month + 1, 1 };
+        qreal scale{ std::ldexp(1.0, request->level) };
+        for (const auto& tile : request->tiles)
+        {
+            if (closing) break;
+            QRect pixels{ TiledMonthItem::getTileRect(request->level, tile, szCalendar) };
+            QImage image{ renderer->renderTile(date, pixels, scale, Qt::GlobalColor::white) };
+            QMetaObject::invokeMethod(this, [this, month = request->month, level = request->level, tile,
+                image = std::move(image)]() {
+                onTilePrefetched(month, level, tile, image);
+            }, Qt::ConnectionType::QueuedConnection);
+        }
+        QMetaObject::invokeMethod(this, [this, month = request->month]() {
+            onMonthPrefetched(month);
+        }, Qt::ConnectionType::QueuedConnection);
     }
 }
 
+void PreviewWindow::onTilePrefetched(int month, int level, const QPoint& tile, const QImage& image)
+{
+    QDate date{ selectedYear, month + 1, 1 };
+    render::TileKey key{ date, level, tile };
+    if (!cache->find(key).has_value())
+        cache->insert(key, cache->getMonthHash(date), QPixmap::fromImage(image));
+}
+
+void PreviewWindow::onMonthPrefetched(int month)
+{
+    pendingMonths.erase(month);
+}
+
 void PreviewWindow::initUi()
 {
     ui->zoomLevel->setMaximum(std::numeric_limits<int>::max());
     ui->zoomLevel->setValue(100);
 
-    QGraphicsScene* scene{ new QGraphicsScene };
+    QGraphicsScene* scene{ new QGraphicsScene{ this } };
     
-    previewPixmap = new QGraphicsPixmapItem{ months[0] };
-    scene->addItem(previewPixmap);
+    int index{ ui->monthToPreview->currentIndex() };
+    previewItem = new TiledMonthItem{ cache, QDate{ selectedYear, index + 1, 1 } };
+    scene->addItem(previewItem);
 
     ui->previewArea->setScene(scene);
 }
@@ -95,10 +142,11 @@ void PreviewWindow::onFitInView()
         (static_cast<double>(ui->previewArea->viewport()->width()) / static_cast<double>(szCalendar.width()))
         * 100.0
     };
-    ui->previewArea->fitInView(previewPixmap, Qt::AspectRatioMode::KeepAspectRatio);
+    ui->previewArea->fitInView(previewItem, Qt::AspectRatioMode::KeepAspectRatio);
     ui->zoomLevel->blockSignals(true);
     ui->zoomLevel->setValue(static_cast<int>(ratio));
     ui->zoomLevel->blockSignals(false);
+    prefetch(ui->monthToPreview->currentIndex());
 }
 
 void PreviewWindow::onNextMonth()
@@ -115,16 +163,9 @@ void PreviewWindow::onPrevMonth()
 
 void PreviewWindow::onPreviewMonthChanged(int value)
 {
-    QGraphicsScene* scene{ ui->previewArea->scene() };
-    assert(scene != nullptr);
-
-    if (previewPixmap != nullptr)
-    {
-        scene->removeItem(previewPixmap);
-        delete previewPixmap;
-    }
-    previewPixmap = new QGraphicsPixmapItem{ months[value] };
-    scene->addItem(previewPixmap);
+    assert(previewItem != nullptr);
+    previewItem->setDate(QDate{ selectedYear, value + 1, 1 });
+    prefetch(value);
 
     if (value >= ui->monthToPreview->count() - 1)
         ui->monthNext->setEnabled(false);
@@ -153,6 +194,7 @@ void PreviewWindow::onZoomLevelChanged(int value)
 {
     ui->previewArea->resetTransform();
     ui->previewArea->scale(value / 100.0, value / 100.0);
+    prefetch(ui->monthToPreview->currentIndex());
 }
 
 void PreviewWindow::onZoomOut()
@@ -4,18 +4,30 @@
 * file, You can obtain one at http ://mozilla.org/MPL/2.0/.
 ************************************************************************************************************/
 #pragma once
+#include <atomic>
 #include <memory>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include <QDialog>
-#include <qgraphicsitem.h>
+#include <QImage>
 #include <qlistwidget.h>
-#include <qpixmap.h>
+#include <QPoint>
 
+#include "render/BoundedQueue.hpp"
+#include "render/MonthRenderer.hpp"
+#include "render/PreviewCache.hpp"
 #include "ui_PreviewWindow.h"
+#include "window/TiledMonthItem.hpp"
 
 /**
  * @brief Window to preview the rendered calendar.
+ *
+ * The selected month is drawn by TiledMonthItem, which only render the visible tiles at a resolution
+ * matching the zoom level. The same tiles of its neighbours are prefetched on a background thread. Rendered
+ * tiles are kept in a render::PreviewCache owned by the main window, so they are reused by the next preview
+ * if the design did not change.
  */
 class PreviewWindow : public QDialog
 {
@@ -23,15 +35,19 @@ class PreviewWindow : public QDialog
 public:
     /** Amount of zoom increment or decrement. */
     static constexpr int zoom_amount{ 5 };
+    /** Amount of months in a year. */
+    static constexpr int month_count{ 12 };
 public:
     /**
      * Construct new preview window.
-     * @param list List of calendar objects to render months' graphics.
+     * @param cache Cache of rendered tiles, must not be nullptr and must be updated with the design.
      * @param year Targeted year to generat calendar.
-     * @param size Size of the calendar design.
      * @param parent Parent of this dialog.
      */
-    PreviewWindow(const QListWidget& list, int year, const QSize& size, QWidget *parent = Q_NULLPTR);
+    PreviewWindow(render::PreviewCache* cache, int year, QWidget *parent = Q_NULLPTR);
+    /**
+     * Stop prefetching and wait for the background thread.
+     */
     ~PreviewWindow() noexcept;
 
 protected:
@@ -53,9 +69,36 @@ private:
     void initUi();
     /**
      * @internal
-     * Render months with provided list.
+     * Tiles of a month requested to the prefetcher.
+     */
+    struct TileRequest
+    {
+        int month;  /**< Index of the month, 0 as January. */
+        int level;  /**< Zoom level of the tiles. */
+        std::vector<QPoint> tiles;  /**< Column and row of the tiles to render. */
+    };
+
+    /**
+     * @internal
+     * Request the visible tiles of the month's neighbours to be rendered in background.
+     * @param index Index of the month, 0 as January.
+     */
+    void prefetch(int index);
+    /**
+     * @internal
+     * Task of the prefetcher thread, render requested tiles until the queue is closed.
+     */
+    void prefetchWorker();
+    /**
+     * @internal
+     * Store a tile rendered by the prefetcher thread, called on the GUI thread.
      */
-    void render(const QListWidget& list);
+    void onTilePrefetched(int month, int level, const QPoint& tile, const QImage& image);
+    /**
+     * @internal
+     * Mark a month as no longer being prefetched, called on the GUI thread.
+     */
+    void onMonthPrefetched(int month);
 private slots:  //Slots
     /**
      * @internal
@@ -110,15 +153,40 @@ private:  //Attributes
     std::unique_ptr<Ui::PreviewWindow> ui{ nullptr };
     /**
      * @internal
-     * Rendered months image.
+     * Cache of rendered months.
      */
-    std::vector<QPixmap> months;
-    
+    render::PreviewCache* cache{ nullptr };
+    /**
+     * @internal
+     * Renderer that hold snapshot of the design.
+     */
+    std::shared_ptr<const render::MonthRenderer> renderer{ nullptr };
+    /**
+     * @internal
+     * Months requested to the prefetcher but not received yet, accessed by GUI thread only.
+     */
+    std::set<int> pendingMonths;
+    /**
+     * @internal
+     * Tiles to render in background.
+     */
+    render::BoundedQueue<TileRequest> prefetchQueue{ PreviewWindow::month_count };
+    /**
+     * @internal
+     * Determine if the window is closing, the prefetcher skip remaining tiles.
+     */
+    std::atomic_bool closing{ false };
+    /**
+     * @internal
+     * Background thread that render the neighbours of the selected month.
+     */
+    std::thread prefetcher;
+
     /**
      * @internal
-     * Current pixmap to preview.
+     * Item that draw the month to preview.
      */
-    QGraphicsPixmapItem* previewPixmap{ nullptr };
+    TiledMonthItem* previewItem{ nullptr };
     /**
      * @internal
      * Size of the calendar design.
@@ -5,7 +5,10 @@
 ************************************************************************************************************/
 #include "window/SimpleCalendarCreator.hpp"
 
+#include <algorithm>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 #include <boost/assert.hpp>
 #include <boost/property_tree/ptree.hpp>
@@ -16,15 +19,23 @@
 #include <qdatetime.h>
 #include <qdebug.h>
 #include <QDesktopServices>
+#include <QElapsedTimer>
 #include <qevent.h>
 #include <qfiledialog.h>
+#include <QInputDialog>
 #include <qmessagebox.h>
 #include <qpainter.h>
+#include <qprogressdialog.h>
+#include <qstatusbar.h>
+#include <qtimer.h>
 
 #include "command/AddObject.hpp"
 #include "command/RemoveObject.hpp"
 #include "command/UndoHistory.hpp"
-#include "element/CalendarObjectFactory.hpp"
+#include "project/EditJournal.hpp"
+#include "project/ProjectFile.hpp"
+#include "project/ProjectLoader.hpp"
+#include "project/ProjectSaver.hpp"
 #include "window/About.hpp"
 #include "window/CalendarResizer.hpp"
 #include "window/EditProjectInfo.hpp"
@@ -35,13 +46,16 @@
 #endif
 
 SimpleCalendarCreator::SimpleCalendarCreator(QWidget *parent)
-    : QMainWindow(parent), ui(std::make_unique<Ui::SimpleCalendarCreatorClass>())
+    : QMainWindow(parent), ui(std::make_unique<Ui::SimpleCalendarCreatorClass>()),
+    journal(std::make_unique<project::EditJournal>())
 {
     ui->setupUi(this);
     connectObjects();
     initUi();
 }
 
+SimpleCalendarCreator::~SimpleCalendarCreator() noexcept = default;
+
 const Ui::SimpleCalendarCreatorClass* SimpleCalendarCreator::getUi() const noexcept
 {
     return ui.get();
@@ -58,8 +72,19 @@ void SimpleCalendarCreator::setProjectName(const QString& value) noexcept
     this->setWindowTitle(QString{ SimpleCalendarCreator::window_title }.arg(value));
 }
 
+void SimpleCalendarCreator::scheduleOutlineUpdate()
+{
+    if (outlineUpdatePending) return;
+    outlineUpdatePending = true;
+    QTimer::singleShot(0, this, &SimpleCalendarCreator::onUpdateOutline);
+}
+
 void SimpleCalendarCreator::closeEvent(QCloseEvent* ev)
 {
+    //Let the running save finish, finished() is not delivered once the window is gone.
+    if (saver != nullptr)
+        onProjectSaved(saver->wait());
+
     if (UndoHistory::getInstance()->hasUnsave())
     {
         auto rst = QMessageBox::warning(this, "Unsaved Work",
@@ -72,6 +97,7 @@ void SimpleCalendarCreator::closeEvent(QCloseEvent* ev)
         }
     }
 
+    journal->discard();
     ev->accept();
 }
 
@@ -92,6 +118,9 @@ void SimpleCalendarCreator::connectObjects()
     connect(ui->actionSave, &QAction::triggered, this, &SimpleCalendarCreator::onSaveProject);
     connect(ui->actionSave_As, &QAction::triggered, this, &SimpleCalendarCreator::onSaveProjectAs);
     connect(ui->actionUndo, &QAction::triggered, []() { UndoHistory::getInstance()->pop(); });
+    journalConnection = UndoHistory::getInstance()->historyChanged.connect([this]() {
+        journal->record(properties, *ui->objectList);
+    });
     connect(ui->btnAddObject, &QPushButton::clicked, this, &SimpleCalendarCreator::onAddObject);
     connect(ui->btnEditObject, &QPushButton::clicked, [this]() {
         auto itm = this->ui->objectList->currentItem();
@@ -105,8 +134,9 @@ void SimpleCalendarCreator::connectObjects()
     });
     connect(ui->btnRemoveObject, &QPushButton::clicked, this, &SimpleCalendarCreator::onRemoveObject);
     connect(ui->btnPreview, &QPushButton::clicked, [this]() {
-        auto previewWindow = std::make_unique<PreviewWindow>(*ui->objectList, properties.selectedYear,
-            properties.szCalendar, this);
+        previewCache.update(*ui->objectList, properties.szCalendar,
+            UndoHistory::getInstance()->getRevision());
+        auto previewWindow = std::make_unique<PreviewWindow>(&previewCache, properties.selectedYear, this);
         previewWindow->exec();
     });
 }
@@ -114,78 +144,113 @@ void SimpleCalendarCreator::connectObjects()
 void SimpleCalendarCreator::initUi()
 {
     onNewProject();
+    //Ask after the window is shown.
+    QTimer::singleShot(0, this, &SimpleCalendarCreator::recoverJournal);
 }
 
-void SimpleCalendarCreator::saveWorker(const QString& path, const QString& createdTime)
+void SimpleCalendarCreator::setEditingEnabled(bool value)
 {
-    
-    if (path.isEmpty()) return;
-
-    QString modTime{ QDateTime::currentDateTimeUtc().toString(Qt::DateFormat::ISODate) };
-
-    boost::property_tree::ptree meta;
-    meta.add("spec.version", "1.0.0");
-    meta.add("app.uid", SimpleCalendarCreator::app_uid);
-    meta.add("app.version", SimpleCalendarCreator::app_version);
-    meta.add("file.version", SimpleCalendarCreator::file_version);
-    meta.add("file.modified", modTime.toStdString());
-
-    if (createdTime.isEmpty())
-        meta.add("file.created", modTime.toStdString());
-    else
-        meta.add("file.created", createdTime.toStdString());
-
-    pugi::xml_document document;
-    auto declaration = document.append_child(pugi::xml_node_type::node_declaration);
-    declaration.append_attribute("version").set_value("1.0");
-    declaration.append_attribute("encoding").set_value("utf-8");
+    ui->gpAction->setEnabled(value);
+    ui->gpProperty->setEnabled(value);
+    ui->menuBar->setEnabled(value);
+    ui->mainToolBar->setEnabled(value);
+}
 
-    auto design = document.append_child("design");
-    auto project = design.append_child("project");
-    project.append_child("target-year").text().set(properties.selectedYear);
-    auto projectSize = project.append_child("size");
-    projectSize.append_attribute("w").set_value(properties.szCalendar.width());
-    projectSize.append_attribute("h").set_value(properties.szCalendar.height());
+void SimpleCalendarCreator::recoverJournal()
+{
+    if (!journal->findRecoverable()) return;
 
-    for (int idx{ 0 }; idx < ui->objectList->count(); idx++)
+    auto result = QMessageBox::question(this, "Recover Unsaved Work", "Unsaved changes of this design are "
+        "found, the program might not exit properly last time. Do you want to recover them?",
+        QMessageBox::Yes | QMessageBox::No);
+    if (result != QMessageBox::Yes)
     {
-        auto item = dynamic_cast<CustomListWidgetItem*>(ui->objectList->item(idx));
-        BOOST_ASSERT_MSG(item != nullptr, "item is not CustomListWidget");
-        auto objectNode = design.append_child("calendar_obj");
-        objectNode.append_attribute("name").set_value(item->text().toUtf8().data());
-        item->getElement()->serialize(&objectNode);
+        journal->dropRecoverable();
+        return;
     }
 
-    std::unique_ptr<libzip::archive> output;  //{ path.toStdString(), ZIP_CREATE };
-
-    if (createdTime.isEmpty())
-        output = std::make_unique<libzip::archive>(path.toStdString(), ZIP_CREATE);
-    else
-        output = std::make_unique<libzip::archive>(path.toStdString());
-
-    auto writeOutput = [&output](const std::string & filename, const libzip::source & source) {
-        try
-        {
-            auto info = output->stat(filename);
-            output->replace(source, info.index);
-        }
-        catch (const std::runtime_error&)
+    QGraphicsScene* scene{ ui->winOutline->scene() };
+    auto checkRow = [](int row, int count) {
+        if (row < 0 || row >= count)
+            throw std::runtime_error{ "Corrupted edit journal." };
+    };
+    try
+    {
+        journal->replay([this, scene, &checkRow](project::EditJournal::Record& record) {
+            int count{ ui->objectList->count() };
+            switch (record.operation)
+            {
+            case project::EditJournal::Operation::properties:
+                properties = record.properties;
+                onPropertiesChanged();
+                break;
+            case project::EditJournal::Operation::insert:
+                checkRow(record.row, count + 1);
+                ui->objectList->insertItem(record.row,
+                    new CustomListWidgetItem{ this, record.name, std::move(record.object) });
+                break;
+            case project::EditJournal::Operation::update:
+            {
+                checkRow(record.row, count);
+                auto item = static_cast<CustomListWidgetItem*>(ui->objectList->item(record.row));
+                item->setText(record.name);
+                item->setElement(std::move(record.object));
+                item->getElement()->setSize(properties.szCalendar);
+                break;
+            }
+            case project::EditJournal::Operation::remove:
+            {
+                checkRow(record.row, count);
+                std::unique_ptr<CustomListWidgetItem> item{
+                    static_cast<CustomListWidgetItem*>(ui->objectList->takeItem(record.row)) };
+                QGraphicsPixmapItem* pixmapItem{ item->getPixmapItem() };
+                if (pixmapItem != nullptr)
+                    scene->removeItem(pixmapItem);
+                break;
+            }
+            }
+        });
+    }
+    catch (const std::exception& e)
+    {
+        //The design is partially replayed, set the journal aside and go back to the saved design.
+        QString keptPath{ journal->keepRecoverable() };
+        QString message{ e.what() };
+        if (!keptPath.isEmpty())
         {
-            output->add(source, filename);
+            message += QString{ "\nThe unsaved changes are kept in \"%1\"." }
+                .arg(QDir::toNativeSeparators(keptPath));
         }
-    };
-
-    std::ostringstream buffer;
-    boost::property_tree::ini_parser::write_ini(buffer, meta);
-    writeOutput("_meta/meta.ini", libzip::source_buffer(buffer.str()));
+        QMessageBox::critical(this, "Error on Recovering Changes", message);
+        QString projectPath{ journal->getProjectPath() };
+        if (projectPath.isEmpty())
+            resetProject();
+        else
+            openProject(projectPath);
+        return;
+    }
 
-    buffer.swap(std::ostringstream{});
-    document.save(buffer, "    ");
-    writeOutput("design.xml", libzip::source_buffer(buffer.str()));
+    //The replayed journal is only removed once the recovered design is journaled again.
+    journal->adoptRecoverable(properties, *ui->objectList);
+    UndoHistory::getInstance()->changesMade();
+}
 
-    savedPath = path;
-    setProjectName(savedPath.completeBaseName());
-    UndoHistory::getInstance()->changesSaved();
+void SimpleCalendarCreator::saveWorker(const QString& path, const QString& createdTime)
+{
+    if (path.isEmpty() || saver != nullptr) return;
+
+    savingRevision = UndoHistory::getInstance()->getRevision();
+    saver = std::make_unique<project::ProjectSaver>(path, properties,
+        project::ProjectSaver::snapshot(*ui->objectList), binaryDesign ?
+        project::ProjectFile::Encoding::binary : project::ProjectFile::Encoding::xml, createdTime);
+    connect(saver.get(), &project::ProjectSaver::finished, this, &SimpleCalendarCreator::onProjectSaved);
+    journal->checkpoint(properties, *ui->objectList);
+
+    //Editing goes on while saving, only actions that replace or save the design wait for it.
+    for (auto action : { ui->actionNew, ui->actionOpen, ui->actionSave, ui->actionSave_As })
+        action->setEnabled(false);
+    statusBar()->showMessage(QString{ "Saving %1..." }.arg(QFileInfo{ path }.fileName()));
+    saver->start();
 }
 
 void SimpleCalendarCreator::onAbout()
@@ -200,56 +265,128 @@ void SimpleCalendarCreator::onAddObject()
     UndoHistory::getInstance()->push(std::make_unique<command::AddObject>(this, ui->objectList));
 }
 
+void SimpleCalendarCreator::onCalendarGenerated(const QString& error)
+{
+    if (exporter != nullptr)
+        statusBar()->showMessage(exporter->getReport().replace('\n', "; "));
+    exporter = nullptr;
+    vectorExporter = nullptr;
+    ui->btnGenerate->setEnabled(true);
+    setProjectName(projectName);
+    if (!error.isEmpty())
+        QMessageBox::critical(this, "Error on Generating Calendar", error);
+}
+
 void SimpleCalendarCreator::onGenerateCalendar()
 {
+    if (exporter != nullptr || vectorExporter != nullptr) return;
+    QStringList formats;
+    for (const auto& itr : render::export_presets)
+        formats.push_back(itr.name);
+    formats.push_back(SimpleCalendarCreator::format_pdf);
+    formats.push_back(SimpleCalendarCreator::format_svg);
+
+    bool accepted{ false };
+    QString format{ QInputDialog::getItem(this, "Generate Calendar", "Output format:", formats, 0, false,
+        &accepted) };
+    if (!accepted) return;
+
     QString path{ QFileDialog::getExistingDirectory(this, "Render Calenders To...") };
     if (path.isEmpty()) return;
 
-    QPixmap graphic{ properties.szCalendar };
-    QPainter painter;
-    QLocale locale{ QLocale::Language::English, QLocale::Country::UnitedKingdom };
-    QString title{ this->windowTitle() };
-    for (QDate date{ properties.selectedYear, 1, 1 }; date.year() == properties.selectedYear;
-        date = date.addMonths(1))
+    auto preset = std::find_if(render::export_presets.begin(), render::export_presets.end(),
+        [&format](const render::ExportPreset& preset) { return format == preset.name; });
+    bool raster{ preset != render::export_presets.end() };
+    auto renderer = std::make_shared<render::MonthRenderer>(render::MonthRenderer::snapshot(*ui->objectList),
+        properties.szCalendar, raster);
+    if (!raster)
     {
-        this->setWindowTitle(QString{ "Generating item %1/12..." }.arg(date.month()));
-        graphic.fill(Qt::GlobalColor::transparent);
-        painter.begin(&graphic);
-        painter.setRenderHint(QPainter::RenderHint::Antialiasing);
-        for (int idx2{ 0 }; idx2 < ui->objectList->count(); idx2++)
-        {
-            auto item = static_cast<CustomListWidgetItem*>(ui->objectList->item(idx2));
-            painter.drawPixmap(QRect{ QPoint{ 0, 0 }, properties.szCalendar },
-                item->getElement()->render(date));
-        }
-        painter.end();
-        graphic.save(QString{ "%1/%2 %3.png" }.arg(path).arg(QString::number(date.month()))
-            .arg(locale.toString(date, "MMMM")), "PNG");
+        generateVectorCalendar(std::move(renderer), format, path);
+        return;
     }
-    this->setWindowTitle(title);
+
+    //Offer a full export when months may be skipped, e.g. the output files are modified by other program.
+    bool incremental{ true };
+    if (QFileInfo::exists(QString{ "%1/%2" }.arg(path).arg(render::CalendarExporter::manifest_file_name)))
+    {
+        auto result = QMessageBox::question(this, "Generate Calendar", "Calendar has been generated to this "
+            "directory before. Do you want to export only the months changed since then?\n"
+            "Choose \"No\" to export every month again.",
+            QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel);
+        if (result == QMessageBox::Cancel) return;
+        incremental = result == QMessageBox::Yes;
+    }
+
+    exporter = std::make_unique<render::CalendarExporter>(std::move(renderer), properties.selectedYear, path,
+        *preset);
+    exporter->setIncremental(incremental);
+    connect(exporter.get(), &render::CalendarExporter::monthExported, this, [this](int count) {
+        this->setWindowTitle(QString{ "Generating item %1/%2..." }.arg(count)
+            .arg(render::CalendarExporter::month_count));
+    });
+    connect(exporter.get(), &render::CalendarExporter::finished, this,
+        &SimpleCalendarCreator::onCalendarGenerated);
+
+    ui->btnGenerate->setEnabled(false);
+    this->setWindowTitle(QString{ "Generating item 0/%1..." }.arg(render::CalendarExporter::month_count));
+    exporter->start();
+}
+
+void SimpleCalendarCreator::generateVectorCalendar(std::shared_ptr<const render::MonthRenderer> renderer,
+    const QString& format, const QString& path)
+{
+    vectorExporter = std::make_unique<render::VectorExporter>(std::move(renderer), properties.selectedYear);
+    QElapsedTimer timer;
+    timer.start();
+    connect(vectorExporter.get(), &render::VectorExporter::monthExported, this, [this](int count) {
+        this->setWindowTitle(QString{ "Generating item %1/%2..." }.arg(count)
+            .arg(render::VectorExporter::month_count));
+    });
+    connect(vectorExporter.get(), &render::VectorExporter::finished, this,
+        [this, format, timer](const QString& error) {
+        if (error.isEmpty())
+            statusBar()->showMessage(QString{ "%1 generated in %2 ms" }.arg(format).arg(timer.elapsed()));
+        onCalendarGenerated(error);
+    });
+
+    ui->btnGenerate->setEnabled(false);
+    this->setWindowTitle(QString{ "Generating item 0/%1..." }.arg(render::VectorExporter::month_count));
+    vectorExporter->start(format == SimpleCalendarCreator::format_pdf ? render::VectorExporter::Format::pdf :
+        render::VectorExporter::Format::svg, path);
 }
 
 bool SimpleCalendarCreator::onNewProject()
 {
-    if (UndoHistory::getInstance()->hasUnsave())
-    {
-        auto result = QMessageBox::information(this, "Unsaved work", QString{ "Operation will cause" }
-            + " unsaved work lost, are your sure to continue?", QMessageBox::Yes | QMessageBox::No);
+    if (!confirmDiscardChanges()) return false;
+    resetProject();
+    return true;
+}
 
-        if (result == QMessageBox::No) return false;
-    }
+bool SimpleCalendarCreator::confirmDiscardChanges()
+{
+    if (!UndoHistory::getInstance()->hasUnsave()) return true;
+
+    auto result = QMessageBox::information(this, "Unsaved work", QString{ "Operation will cause" }
+        + " unsaved work lost, are your sure to continue?", QMessageBox::Yes | QMessageBox::No);
+    return result != QMessageBox::No;
+}
 
+void SimpleCalendarCreator::resetProject()
+{
     setProjectName();
     QDate today{ QDate::currentDate() };
     properties = {
         today.year(),
         SimpleCalendarCreator::default_calender_size
     };
+    binaryDesign = false;
     ui->labYear->setText(QString{ EditProjectInfo::format_targeted_year }.arg(properties.selectedYear));
     ui->szCalendarIndicator->setText(QString{ EditProjectInfo::format_calendar_size }
         .arg(properties.szCalendar.width()).arg(properties.szCalendar.height()));
 
     ui->objectList->clear();
+    UndoHistory::getInstance()->clearHistory();
+    journal->start(QString{}, properties, *ui->objectList);
     
     QGraphicsScene* scene{ ui->winOutline->scene() };
     if (scene != nullptr)  //Delete previous scene if exits
@@ -276,115 +413,114 @@ bool SimpleCalendarCreator::onNewProject()
     }
 
     UndoHistory::getInstance()->changesSaved();
-    return true;
 }
 
 void SimpleCalendarCreator::onOpenProject()
 {
-    constexpr std::string_view error_dialog_title{ "Error on Opening File" };
+    if (loader != nullptr) return;
 
     auto path = QFileDialog::getOpenFileName(this, "Open file...", QDir::homePath(),
         "Calendar design(*.calendar)");
     if (path.isEmpty()) return;
-    
-    if (!onNewProject()) return;
+    if (!confirmDiscardChanges()) return;
+    openProject(path);
+}
 
-    std::unique_ptr<libzip::archive> container{ nullptr };
-    try
-    {
-        container = std::make_unique<libzip::archive>(path.toStdString());
-    }
-    catch (const std::runtime_error & e)
-    {
-#ifdef _DEBUG
-        qDebug() << e.what();
-#endif // _DEBUG
-        BOOST_ASSERT_MSG(false, "Critical error occured");
-    }
+void SimpleCalendarCreator::openProject(const QString& path)
+{
+    if (loader != nullptr) return;
+
+    //The current design is kept until the file is parsed, see onProjectOpened().
+    openReplacedDesign = false;
+    loader = std::make_unique<project::ProjectLoader>(path);
+    connect(loader.get(), &project::ProjectLoader::opened, this, &SimpleCalendarCreator::onProjectOpened);
+    connect(loader.get(), &project::ProjectLoader::objectLoaded, this,
+        &SimpleCalendarCreator::onObjectLoaded);
+    connect(loader.get(), &project::ProjectLoader::finished, this, &SimpleCalendarCreator::onProjectLoaded);
+
+    openProgress = std::make_unique<QProgressDialog>(
+        QString{ "Opening %1..." }.arg(QFileInfo{ path }.fileName()), "Cancel", 0, 0, this);
+    openProgress->setWindowTitle("Open file...");
+    openProgress->setMinimumDuration(SimpleCalendarCreator::open_progress_delay);
+    connect(openProgress.get(), &QProgressDialog::canceled, loader.get(), &project::ProjectLoader::cancel);
+
+    setEditingEnabled(false);
+    loader->start();
+}
 
-    boost::property_tree::ptree metaIni;
+void SimpleCalendarCreator::onProjectOpened()
+{
+    resetProject();
+    openReplacedDesign = true;
+    properties = loader->getProperties();
+    binaryDesign = loader->getEncoding() == project::ProjectFile::Encoding::binary;
+    onPropertiesChanged();
+}
 
-    auto reader = [&container](const std::string & name) -> std::string {
-        libzip::stat stat{ container->stat(name) };
-        return container->open(stat.index).read(stat.size);
-    };
+void SimpleCalendarCreator::onObjectLoaded(int loaded, int total)
+{
+    //Outlines of the new items are rendered in batches by onUpdateOutline().
+    for (auto& [name, object] : loader->takeObjects())
+        ui->objectList->addItem(new CustomListWidgetItem{ this, name, std::move(object) });
 
-    try
-    {
-        std::istringstream ss{ reader("_meta/meta.ini") };
-        boost::property_tree::ini_parser::read_ini(ss, metaIni);
-    }
-    catch (const std::exception& e)
-    {
-        QMessageBox::critical(this, error_dialog_title.data(), e.what());
-        return;
-    }
+    openProgress->setMaximum(total);
+    openProgress->setValue(loaded);
+}
 
-    auto specVer = QString::fromStdString(metaIni.get<std::string>("spec.version"));
-    auto appId = QString::fromStdString(metaIni.get<std::string>("app.uid"));
-    auto fileVersion = QString::fromStdString(metaIni.get<std::string>("file.version"));
-    if (appId != SimpleCalendarCreator::app_uid)
-    {
-        QMessageBox::critical(this, static_cast<std::string>(error_dialog_title).c_str(),
-            "Simple Calendar Creator is unable to open this file.");
-        return;
-    }
+void SimpleCalendarCreator::onProjectLoaded(const QString& error)
+{
+    constexpr std::string_view error_dialog_title{ "Error on Opening File" };
 
-    if (specVer > "1.0.0" || fileVersion > SimpleCalendarCreator::file_version)
-    {
-        QMessageBox::critical(this, error_dialog_title.data(),
-            "Unable to open file, it's designed for newer program");
-        return;
-    }
+    bool cancelled{ loader->isCancelled() };
+    QString path{ loader->getPath() };
+    loader = nullptr;
+    openProgress = nullptr;
+    setEditingEnabled(true);
 
-    pugi::xml_document document;
-    try
+    if (!error.isEmpty())
     {
-        std::istringstream ss{ reader("design.xml") };
-        auto result = document.load(ss);
-        if (result.status != pugi::xml_parse_status::status_ok)
-            throw std::runtime_error{ result.description() };
-    }
-    catch (const std::exception& e)
-    {
-        QMessageBox::critical(this, error_dialog_title.data(), e.what());
+        //Discard the partially loaded design, the current design is untouched if the file is not parsed.
+        if (openReplacedDesign)
+            resetProject();
+        if (!cancelled)
+            QMessageBox::critical(this, error_dialog_title.data(), error);
         return;
     }
 
-    auto design = document.first_child();
-    auto project = design.child("project");
-    properties.selectedYear = project.child("target-year").text().as_int(1997);
-    
-    auto projectSize = project.child("size");
-    properties.szCalendar = QSize{
-        projectSize.attribute("w").as_int(),
-        projectSize.attribute("h").as_int()
-    };
-    onPropertiesChanged();
+    savedPath = path;
+    setProjectName(savedPath.completeBaseName());
+    UndoHistory::getInstance()->changesSaved();
+    journal->start(path, properties, *ui->objectList);
+    recoverJournal();
+}
+
+void SimpleCalendarCreator::onProjectSaved(const QString& error)
+{
+    if (saver == nullptr) return;
 
-    CalendarObjectFactory factory;
-    for (auto itr : design)
+    QString path{ saver->getPath() };
+    project::ProjectFile::SaveStatistics statistics{ saver->getStatistics() };
+    saver = nullptr;
+    for (auto action : { ui->actionNew, ui->actionOpen, ui->actionSave, ui->actionSave_As })
+        action->setEnabled(true);
+
+    if (!error.isEmpty())
     {
-        using namespace std::string_literals;
-        if (itr.name() != "calendar_obj"s) continue;
-        try
-        {
-            auto item = new CustomListWidgetItem{ this, itr.attribute("name").as_string(),
-                factory.createObject(itr.attribute("type").as_string()) };
-            ui->objectList->addItem(item);
-            item->getElement()->deserialize(itr);
-        }
-        catch (const std::out_of_range & e)
-        {
-#ifdef _DEBUG
-            qDebug() << e.what();
-#endif // _DEBUG
-            continue;
-        }
+        statusBar()->clearMessage();
+        QMessageBox::critical(this, "Error on saving file", error);
+        return;
     }
+
     savedPath = path;
     setProjectName(savedPath.completeBaseName());
-    UndoHistory::getInstance()->changesSaved();
+    //Changes made while saving are not in the saved file, journal them again on top of it.
+    journal->restart(path);
+    journal->record(properties, *ui->objectList);
+    if (UndoHistory::getInstance()->getRevision() == savingRevision)
+        UndoHistory::getInstance()->changesSaved();
+    statusBar()->showMessage(QString{ "Saved %1 KiB of design; serialize: %2 ms, stage: %3 ms, "
+        "compress and write: %4 ms" }.arg(statistics.designSize / 1024).arg(statistics.serializeTime)
+        .arg(statistics.stageTime).arg(statistics.writeTime));
 }
 
 void SimpleCalendarCreator::onPropertiesChanged()
@@ -466,8 +602,14 @@ void SimpleCalendarCreator::onSaveProject()
 
 void SimpleCalendarCreator::onSaveProjectAs()
 {
+    constexpr char* const filter_xml{ "Calendar design(*.calendar)" };
+    constexpr char* const filter_binary{ "Calendar design, compact binary(*.calendar)" };
+
+    QString selectedFilter{ binaryDesign ? filter_binary : filter_xml };
     QString path{ QFileDialog::getSaveFileName(this, "Save as", QDir::homePath(),
-        "Calendar design(*.calendar)") };
+        QString{ "%1;;%2" }.arg(filter_xml).arg(filter_binary), &selectedFilter) };
+    if (path.isEmpty()) return;
+    binaryDesign = selectedFilter == filter_binary;
 #ifdef _DEBUG
     qDebug() << "output path: " << path;
 #endif // _DEBUG
@@ -483,3 +625,23 @@ void SimpleCalendarCreator::onShowDependencies()
         QMessageBox::information(this, "Operation Failed", "Failed to open " + path.toString());
     }
 }
+
+void SimpleCalendarCreator::onUpdateOutline()
+{
+    outlineUpdatePending = false;
+
+    //Items added to the scene in one pass are repainted together by the view.
+    QElapsedTimer timer;
+    timer.start();
+    for (int idx{ 0 }; idx < ui->objectList->count(); idx++)
+    {
+        if (timer.elapsed() >= SimpleCalendarCreator::outline_update_budget)
+        {
+            scheduleOutlineUpdate();
+            return;
+        }
+        auto item = dynamic_cast<CustomListWidgetItem*>(ui->objectList->item(idx));
+        BOOST_ASSERT_MSG(item != nullptr, "item is not CustomListWidget");
+        item->updateOutline();
+    }
+}
@@ -6,15 +6,30 @@
 #pragma once
 #include "ui_SimpleCalendarCreator.h"
 
+#include <cstdint>
 #include <memory>
 #include <stack>
 
 #include <qfileinfo.h>
 #include <QtWidgets/QMainWindow>
 
+#include <boost/signals2/connection.hpp>
+
 #include <zip.hpp>
 
 #include "command/Command.hpp"
+#include "render/CalendarExporter.hpp"
+#include "render/PreviewCache.hpp"
+#include "render/VectorExporter.hpp"
+
+class QProgressDialog;
+
+namespace project
+{
+    class EditJournal;
+    class ProjectLoader;
+    class ProjectSaver;
+}
 
 /**
  * @brief properties of calendar.
@@ -62,9 +77,21 @@ public:
     /** Uid of the applab project. */
     static constexpr char* const app_uid{ "io.gitlab.kelvinchin12070811.simplecalendarcreator" };
     /** Version of the file format, in major.minor.bugfix format.*/
-    static constexpr char* const file_version{ "1.0.0" };
+    static constexpr char* const file_version{ "1.1.0" };
+    /** Output format of vector export, one PDF document with a page per month. */
+    static constexpr char* const format_pdf{ "PDF document" };
+    /** Output format of vector export, one SVG image per month. */
+    static constexpr char* const format_svg{ "SVG images" };
+    /** Time in ms to render dirty outlines before returning to the event loop. */
+    static constexpr int outline_update_budget{ 16 };
+    /** Time in ms before the progress of opening a project is shown. */
+    static constexpr int open_progress_delay{ 500 };
 public:
     SimpleCalendarCreator(QWidget *parent = Q_NULLPTR);
+    /**
+     * Cancel the project being opened and wait for the loader to stop.
+     */
+    ~SimpleCalendarCreator() noexcept;
     /**
      * Get ui elements of the MainWindow.
      */
@@ -82,6 +109,13 @@ public:  //Setters
      */
     void setProjectName(const QString& value = "Untitled") noexcept;
 
+public:
+    /**
+     * Render dirty outlines of the calendar objects once the control returns to the event loop. Outlines are
+     * rendered in z-order, a batch at a time so the window stays responsive while a large project is opened.
+     */
+    void scheduleOutlineUpdate();
+
 protected:
     /**
      * @internal
@@ -105,14 +139,46 @@ private:
      * Additional steps to initialize UI.
      */
     void initUi();
+    /**
+     * @internal
+     * Enable or disable the actions that modify the design, disabled while a project is being opened.
+     */
+    void setEditingEnabled(bool value);
+    /**
+     * @internal
+     * Ask the user to confirm when there are unsaved changes.
+     * @return true if proceed.
+     */
+    bool confirmDiscardChanges();
+    /**
+     * @internal
+     * Replace the design with an empty design without asking.
+     */
+    void resetProject();
+    /**
+     * @internal
+     * Offer to replay the edit journal left by a previous run onto the design just opened.
+     */
+    void recoverJournal();
     /**
      * @internal
      * General algorithm to save file. Save file will only update modified date while save as will update
-     * everything.
+     * everything. The design is encoded as selected by binaryDesign. A snapshot of the design is saved on a
+     * worker thread so editing can go on, onProjectSaved() is called when done.
      * @param path Path to save project.
      * @param createdTime Time when the file is created. Empty for not created yet.
      */
     void saveWorker(const QString& path, const QString& createdTime = QString{});
+    /**
+     * @internal
+     * Start exporting the calendar as vector graphics in background, onCalendarGenerated() is called when
+     * done.
+     * @param renderer Renderer that hold the snapshot of the design.
+     * @param format Selected output format, format_pdf or format_svg.
+     * @param path Directory to write the output.
+     */
+    void generateVectorCalendar(std::shared_ptr<const render::MonthRenderer> renderer, const QString& format,
+        const QString& path);
 
 private slots:
     /**
@@ -125,6 +191,12 @@ private slots:
      * Slot when a calendar object is being to add to the design.
      */
     void onAddObject();
+    /**
+     * @internal
+     * Slot called when the background export started by onGenerateCalendar() is done.
+     * @param error Empty on success, otherwise the error message.
+     */
+    void onCalendarGenerated(const QString& error);
     /**
      * @internal
      * Slot called when tend to generate final calendar design.
@@ -138,9 +210,38 @@ private slots:
     bool onNewProject();
     /**
      * @internal
-     * Slot when user open existing project.
+     * Slot called when a calendar object of the project being opened is loaded.
+     * @param loaded Amount of objects loaded so far.
+     * @param total Amount of objects in the project.
+     */
+    void onObjectLoaded(int loaded, int total);
+    /**
+     * @internal
+     * Slot when user open existing project, the project is loaded in background.
      */
     void onOpenProject();
+    /**
+     * @internal
+     * Start loading the project at @p path in background, the current design is kept until it's parsed.
+     */
+    void openProject(const QString& path);
+    /**
+     * @internal
+     * Slot called when the file of the project being opened is parsed.
+     */
+    void onProjectOpened();
+    /**
+     * @internal
+     * Slot called when the background load started by onOpenProject() is done.
+     * @param error Empty on success, otherwise the error message.
+     */
+    void onProjectLoaded(const QString& error);
+    /**
+     * @internal
+     * Slot called when the background save is done.
+     * @param error Empty on success, otherwise the error message.
+     */
+    void onProjectSaved(const QString& error);
     /**
      * @internal
      * Slot called when CalendarProperties changed.
@@ -166,6 +267,11 @@ private slots:
      * Slot called when tend to open dependencies licenses.
      */
     void onShowDependencies();
+    /**
+     * @internal
+     * Slot called to render the dirty outlines scheduled by scheduleOutlineUpdate().
+     */
+    void onUpdateOutline();
 
 private:
     /**
@@ -188,4 +294,64 @@ private:
      * Name of the project, "Untitled" by default.
      */
     QString projectName;
+    /**
+     * @internal
+     * Determine if the project is saved with the compact binary design instead of XML.
+     */
+    bool binaryDesign{ false };
+    /**
+     * @internal
+     * Determine if onUpdateOutline() is scheduled.
+     */
+    bool outlineUpdatePending{ false };
+    /**
+     * @internal
+     * Running export of the calendar design, nullptr if not exporting.
+     */
+    std::unique_ptr<render::CalendarExporter> exporter{ nullptr };
+    /**
+     * @internal
+     * Running vector export of the calendar design, nullptr if not exporting.
+     */
+    std::unique_ptr<render::VectorExporter> vectorExporter{ nullptr };
+    /**
+     * @internal
+     * Rendered months of the preview, reused while the design is unchanged.
+     */
+    render::PreviewCache previewCache;
+    /**
+     * @internal
+     * Loader of the project being opened, nullptr if not opening.
+     */
+    std::unique_ptr<project::ProjectLoader> loader{ nullptr };
+    /**
+     * @internal
+     * Progress of the project being opened, nullptr if not opening.
+     */
+    std::unique_ptr<QProgressDialog> openProgress{ nullptr };
+    /**
+     * @internal
+     * Determine if the project being opened has replaced the design, set once its file is parsed.
+     */
+    bool openReplacedDesign{ false };
+    /**
+     * @internal
+     * Saver of the project being saved, nullptr if not saving.
+     */
+    std::unique_ptr<project::ProjectSaver> saver{ nullptr };
+    /**
+     * @internal
+     * Revision of UndoHistory when the running save took its snapshot.
+     */
+    std::uint64_t savingRevision{ 0 };
+    /**
+     * @internal
+     * Journal of the edits made since the design is last saved.
+     */
+    std::unique_ptr<project::EditJournal> journal{ nullptr };
+    /**
+     * @internal
+     * Connection that record UndoHistory changes to journal, disconnected before journal is destroyed.
+     */
+    boost::signals2::scoped_connection journalConnection;
 };
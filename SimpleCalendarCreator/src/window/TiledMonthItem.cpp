@@ -0,0 +1,100 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#include "window/TiledMonthItem.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/assert.hpp>
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+TiledMonthItem::TiledMonthItem(render::PreviewCache* cache, const QDate& date, QGraphicsItem* parent):
+    QGraphicsItem(parent), cache(cache), date(date.year(), date.month(), 1)
+{
+    BOOST_ASSERT_MSG(cache != nullptr && cache->getRenderer() != nullptr, "cache must be updated");
+    setFlag(QGraphicsItem::GraphicsItemFlag::ItemUsesExtendedStyleOption);
+}
+
+std::pair<int, QRect> TiledMonthItem::getTiles(const QRectF& region, qreal scale, const QSize& size)
+{
+    int level{ TiledMonthItem::max_level };
+    if (scale > 0)
+    {
+        level = std::clamp(static_cast<int>(std::ceil(std::log2(scale))), TiledMonthItem::min_level,
+            TiledMonthItem::max_level);
+    }
+
+    QRectF visible{ region & QRectF{ QPointF{ 0, 0 }, QSizeF{ size } } };
+    if (visible.isEmpty())
+        return { level, QRect{} };
+
+    qreal extent{ TiledMonthItem::tile_size / std::ldexp(1.0, level) };  //Size of a tile in the design.
+    QPoint first{ static_cast<int>(visible.left() / extent), static_cast<int>(visible.top() / extent) };
+    QPoint last{ static_cast<int>(std::ceil(visible.right() / extent)) - 1,
+        static_cast<int>(std::ceil(visible.bottom() / extent)) - 1 };
+    return { level, QRect{ first, last } };
+}
+
+QRect TiledMonthItem::getTileRect(int level, const QPoint& tile, const QSize& size)
+{
+    qreal scale{ std::ldexp(1.0, level) };
+    QSize scaledSize{ static_cast<int>(std::ceil(size.width() * scale)),
+        static_cast<int>(std::ceil(size.height() * scale)) };
+    QRect tileRect{ tile * TiledMonthItem::tile_size,
+        QSize{ TiledMonthItem::tile_size, TiledMonthItem::tile_size } };
+    return tileRect & QRect{ QPoint{ 0, 0 }, scaledSize };
+}
+
+const QDate& TiledMonthItem::getDate() const noexcept
+{
+    return date;
+}
+
+void TiledMonthItem::setDate(const QDate& value)
+{
+    date = QDate{ value.year(), value.month(), 1 };
+    update();
+}
+
+QRectF TiledMonthItem::boundingRect() const
+{
+    return QRectF{ QPointF{ 0, 0 }, QSizeF{ cache->getRenderer()->getSize() } };
+}
+
+void TiledMonthItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+{
+    auto renderer = cache->getRenderer();
+    qreal viewScale{ option->levelOfDetailFromTransform(painter->worldTransform()) };
+    auto [level, tiles] = getTiles(option->exposedRect, viewScale, renderer->getSize());
+    if (tiles.isEmpty()) return;
+
+    qreal scale{ std::ldexp(1.0, level) };
+    painter->save();
+    painter->setRenderHint(QPainter::RenderHint::SmoothPixmapTransform);
+    for (int row{ tiles.top() }; row <= tiles.bottom(); row++)
+    {
+        for (int column{ tiles.left() }; column <= tiles.right(); column++)
+        {
+            render::TileKey key{ date, level, QPoint{ column, row } };
+            QRect pixels{ getTileRect(level, key.tile, renderer->getSize()) };
+            if (pixels.isEmpty()) continue;
+
+            auto tile = cache->find(key);
+            if (!tile.has_value())
+            {
+                tile = QPixmap::fromImage(renderer->renderTile(date, pixels, scale, Qt::GlobalColor::white));
+                cache->insert(key, cache->getMonthHash(date), *tile);
+            }
+
+            QRectF target{ pixels.x() / scale, pixels.y() / scale, pixels.width() / scale,
+                pixels.height() / scale };
+            painter->drawPixmap(target, *tile, QRectF{ tile->rect() });
+        }
+    }
+    painter->restore();
+}
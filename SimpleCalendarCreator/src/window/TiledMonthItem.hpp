@@ -0,0 +1,80 @@
+/************************************************************************************************************
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0.If a copy of the MPL was not distributed with this
+* file, You can obtain one at http ://mozilla.org/MPL/2.0/.
+************************************************************************************************************/
+#pragma once
+#include <utility>
+
+#include <QDate>
+#include <qgraphicsitem.h>
+#include <QRect>
+#include <QSize>
+
+#include "render/PreviewCache.hpp"
+
+/**
+ * @brief Graphics item that preview a month at the resolution needed by the view.
+ *
+ * The month is split into tiles rendered at a zoom level close to the view's scale, only the tiles that
+ * are exposed get rendered. Levels are powers of 2, so a rendered tile is never scaled by more than half
+ * while painting and tiles are reused while zooming between two levels.
+ */
+class TiledMonthItem : public QGraphicsItem
+{
+public:
+    /** Width and height of a tile in pixels. */
+    static constexpr int tile_size{ 256 };
+    /** Minimum zoom level, 1/64 of the design. */
+    static constexpr int min_level{ -6 };
+    /** Maximum zoom level, 16 times of the design. */
+    static constexpr int max_level{ 4 };
+public:
+    /**
+     * Create new item.
+     * @param cache Cache of rendered tiles, must not be nullptr and must be updated with the design.
+     * @param date Month to preview.
+     * @param parent Parent of this item.
+     */
+    TiledMonthItem(render::PreviewCache* cache, const QDate& date, QGraphicsItem* parent = nullptr);
+
+    /**
+     * Get the zoom level and the range of tiles needed to paint a region of the design.
+     * @param region Region of the design to paint.
+     * @param scale Scale of the view.
+     * @param size Size of the calendar design.
+     * @return Zoom level and the columns and rows of tiles.
+     */
+    static std::pair<int, QRect> getTiles(const QRectF& region, qreal scale, const QSize& size);
+    /**
+     * Get the pixels covered by a tile, in the design scaled to the zoom level.
+     * @param level Zoom level of the tile.
+     * @param tile Column and row of the tile.
+     * @param size Size of the calendar design.
+     */
+    static QRect getTileRect(int level, const QPoint& tile, const QSize& size);
+
+    /**
+     * Get the month to preview.
+     */
+    const QDate& getDate() const noexcept;
+    /**
+     * Set the month to preview and repaint the item.
+     */
+    void setDate(const QDate& value);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
+private:
+    /**
+     * @internal
+     * Cache of rendered tiles.
+     */
+    render::PreviewCache* cache{ nullptr };
+    /**
+     * @internal
+     * First day of the month to preview.
+     */
+    QDate date;
+};